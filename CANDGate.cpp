@@ -2,6 +2,7 @@
 //
 //--Includes-------------------------------------------------------------------
 #include "CANDGate.h"
+#include "CNetlist.h"
 
 //---CANDGate Implementation--------------------------------------------------
 CANDGate::CANDGate() : CLogic()
@@ -15,18 +16,25 @@ CANDGate::CANDGate() : CLogic()
 void CANDGate::ComputeOutput()
 {
     // AND logic
+    eLogicLevel output;
     if (mInputs[0] == LOGIC_UNDEFINED || mInputs[1] == LOGIC_UNDEFINED)
     {
-        mOutputs[0] = LOGIC_UNDEFINED;
+        output = LOGIC_UNDEFINED;
     }
     else if (mInputs[0] == LOGIC_HIGH && mInputs[1] == LOGIC_HIGH)
     {
-        mOutputs[0] = LOGIC_HIGH;
+        output = LOGIC_HIGH;
     }
     else
     {
-        mOutputs[0] = LOGIC_LOW;
+        output = LOGIC_LOW;
     }
-    // Drive output
-    if (mpOutputConnections[0] != NULL) mpOutputConnections[0]->DriveLevel(mOutputs[0]);
+    // Drive output if it changed
+    DriveOutput(0, output);
+}
+
+void CANDGate::Flatten(CNetlist &aNetlist, const std::string &,
+                       const std::vector<int> &aInputNets, const std::vector<int> &aOutputNets)
+{
+    aNetlist.AddGate(GATE_AND, aInputNets[0], aInputNets[1], aOutputNets[0]);
 }
\ No newline at end of file
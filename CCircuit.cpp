@@ -2,10 +2,18 @@
 //
 //--Includes-------------------------------------------------------------------
 #include "CCircuit.h"
+#include "CNetlist.h"
+
+#include <algorithm>
 
 //---CCircuit Implementation--------------------------------------------------
 
-CCircuit::CCircuit():CLogic(){}
+CCircuit::CCircuit():CLogic()
+{
+    untappedOutputs = 0;
+    mAssignment = 0;
+    mUndefinedInputs = 0;
+}
 
 CCircuit::~CCircuit()
 {
@@ -16,25 +24,89 @@ CCircuit::~CCircuit()
 
 void CCircuit::ConnectWireToLogic(std::string wire, std::string logic, int input)
 {
+    Expand();
     mWires[wire]->AddOutputConnection(mLogics[logic], input);
 }
 
 void CCircuit::ConnectLogicToWire(std::string logic, int output, std::string wire)
 {
+    Expand();
     mLogics[logic]->ConnectOutput(output, mWires[wire]);
 }
 
 void CCircuit::AddLogic(std::string logic, CLogic* clogic)
 {
+    Expand();
     // Add logic if its name is not already used
     if (mLogics.find(logic) == mLogics.end()) 
     {
         mLogics[logic] = clogic;
+        if (untappedOutputs > 0) UpdateOutputs();
+    }
+}
+
+void CCircuit::RemoveLogic(std::string logic)
+{
+    Expand();
+    std::unordered_map<std::string, CLogic*>::iterator it = mLogics.find(logic);
+    if (it == mLogics.end()) return;
+    CLogic* clogic = it->second;
+
+    // Disconnect inputs, then leave driven wires and mapped outputs undefined
+    for (std::pair<std::string, CWire*> p : mWires) p.second->RemoveOutputConnection(clogic);
+    for (int i = 0; i < clogic->OutputSize(); i++)
+    {
+        if (clogic->GetOutputConnection(i) != NULL) 
+        {
+            clogic->GetOutputConnection(i)->DriveLevel(LOGIC_UNDEFINED);
+        }
+    }
+    for (int i = outputMap.size() - 1; i >= 0; i--)
+    {
+        if (std::get<0>(outputMap[i]) != logic) continue;
+        DriveOutput(std::get<2>(outputMap[i]), LOGIC_UNDEFINED);
+        outputMap.erase(outputMap.begin() + i);
+    }
+
+    mLogics.erase(it);
+    delete clogic;
+    UpdateOutputs();
+}
+
+void CCircuit::ReplaceLogic(std::string logic, CLogic* clogic)
+{
+    Expand();
+    std::unordered_map<std::string, CLogic*>::iterator it = mLogics.find(logic);
+    if (it == mLogics.end()) return;
+    CLogic* old = it->second;
+
+    // Take over the old element's wires, then its input levels, which drives the new outputs.
+    // The new element reports to this circuit once UpdateOutputs maps it.
+    for (std::pair<std::string, CWire*> p : mWires) p.second->ReplaceOutputConnection(old, clogic);
+    for (int i = 0; i < old->OutputSize(); i++)
+    {
+        if (old->GetOutputConnection(i) != NULL) clogic->ConnectOutput(i, old->GetOutputConnection(i));
+    }
+    for (int i = 0; i < old->InputSize(); i++)
+    {
+        clogic->DriveInput(i, old->GetInputState(i));
     }
+
+    it->second = clogic;
+    delete old;
+    UpdateOutputs();
+}
+
+void CCircuit::DisconnectWireFromLogic(std::string wire, std::string logic, int input)
+{
+    Expand();
+    mWires[wire]->RemoveOutputConnection(mLogics[logic], input);
+    mLogics[logic]->DriveInput(input, LOGIC_UNDEFINED);
 }
 
 void CCircuit::AddWire(std::string wire)
 {
+    Expand();
     // Add wire if its name is not already used
     if (mWires.find(wire) == mWires.end()) 
     {
@@ -44,6 +116,7 @@ void CCircuit::AddWire(std::string wire)
 
 void CCircuit::MapInput(std::string wire, int circuitInput)
 {
+    Expand();
     // If circuitInput is default value, set it as a new input
     if (circuitInput < 0){
         circuitInput = mInputs.size();
@@ -52,7 +125,9 @@ void CCircuit::MapInput(std::string wire, int circuitInput)
     // Expand inputs
     while(int(mInputs.size()) < circuitInput + 1){
         mInputs.push_back(LOGIC_UNDEFINED);
+        inputWires.push_back(std::vector<std::string>());
     }
+    inputWires[circuitInput].push_back(wire);
 
     // Add mapping
     inputMap.push_back(std::make_tuple(
@@ -63,6 +138,7 @@ void CCircuit::MapInput(std::string wire, int circuitInput)
 
 void CCircuit::MapOutput(std::string logic, int logicOutput, int circuitOutput)
 {
+    Expand();
     // If circuitOutput is default value, set it as a new output
     if (circuitOutput < 0){
         circuitOutput = mOutputs.size();
@@ -80,6 +156,30 @@ void CCircuit::MapOutput(std::string logic, int logicOutput, int circuitOutput)
         logicOutput, 
         circuitOutput
         ));
+    TapOutput(outputMap.back());
+}
+
+void CCircuit::DriveInput(int aInputIndex, eLogicLevel aNewLevel)
+{
+    mInputs[aInputIndex] = aNewLevel;
+    if (mpTable)
+    {
+        // Look up every output, which drives on only those that changed
+        uint32_t bit = uint32_t(1) << (mInputs.size() - 1 - aInputIndex);
+        mAssignment = (aNewLevel == LOGIC_HIGH) ? (mAssignment | bit) : (mAssignment & ~bit);
+        mUndefinedInputs = (aNewLevel == LOGIC_UNDEFINED) ? (mUndefinedInputs | bit) : (mUndefinedInputs & ~bit);
+        for (int i = 0; i < int(mOutputs.size()); i++)
+        {
+            DriveOutput(i, mpTable->GetOutput(i, mAssignment, mUndefinedInputs));
+        }
+        return;
+    }
+
+    // Other inputs are unchanged, so their wires need not be driven again
+    for (std::string wire : inputWires[aInputIndex])
+    {
+        mWires[wire]->DriveLevel(aNewLevel);
+    }
 }
 
 void CCircuit::ComputeOutput()
@@ -89,15 +189,223 @@ void CCircuit::ComputeOutput()
     {
         mWires[std::get<1>(t)]->DriveLevel(mInputs[std::get<0>(t)]);
     }
-    
+    // Outputs follow through ChildOutputChanged
+}
+
+void CCircuit::TapOutput(std::tuple<std::string, int, int> mapping)
+{
+    std::unordered_map<std::string, CLogic*>::iterator it = mLogics.find(std::get<0>(mapping));
+    if (it == mLogics.end())
+    {
+        untappedOutputs++;
+        return;
+    }
+
+    // The logic reports its output changes to this circuit from now on
+    it->second->SetParent(this);
+    outputTaps[it->second].push_back(std::make_pair(std::get<1>(mapping), std::get<2>(mapping)));
+    DriveOutput(std::get<2>(mapping), it->second->GetOutputState(std::get<1>(mapping)));
+}
+
+void CCircuit::UpdateOutputs()
+{
     // Look through output mapping and drive all outputs.
+    outputTaps.clear();
+    untappedOutputs = 0;
+    for (std::tuple<std::string, int, int> t : outputMap) TapOutput(t);
+}
+
+void CCircuit::ChildOutputChanged(CLogic *apChild, int aOutputIndex)
+{
+    std::unordered_map<CLogic*, std::vector<std::pair<int, int>>>::iterator it = outputTaps.find(apChild);
+    if (it == outputTaps.end()) return;
+    for (std::pair<int, int> tap : it->second)
+    {
+        if (tap.first == aOutputIndex) DriveOutput(tap.second, apChild->GetOutputState(aOutputIndex));
+    }
+}
+
+void CCircuit::ClockSample()
+{
+    for (std::pair<std::string, CLogic*> p : mLogics) p.second->ClockSample();
+}
+
+void CCircuit::ClockCommit()
+{
+    for (std::pair<std::string, CLogic*> p : mLogics) p.second->ClockCommit();
+}
+
+int CCircuit::Collapse(int aMaxInputs, size_t aBudget)
+{
+    std::unordered_multimap<size_t, std::shared_ptr<const CTruthTable>> tables;
+    return CollapseWith(std::min(aMaxInputs, 20), aBudget, tables);
+}
+
+bool CCircuit::IsCollapsed()
+{
+    return mpTable != NULL;
+}
+
+int CCircuit::CollapseWith(int aMaxInputs, size_t &aBudget,
+                           std::unordered_multimap<size_t, std::shared_ptr<const CTruthTable>> &aTables)
+{
+    Expand();
+    if (int(mInputs.size()) <= aMaxInputs && !mLogics.empty())
+    {
+        CNetlist netlist(this);
+        if (netlist.LoopSize() == 0 && netlist.FlopSize() == 0)
+        {
+            // Share a table with the same response, else build one if the budget allows
+            std::shared_ptr<const CTruthTable> table = std::make_shared<const CTruthTable>(netlist);
+            std::shared_ptr<const CTruthTable> shared;
+            auto range = aTables.equal_range(table->Hash());
+            for (auto it = range.first; it != range.second && !shared; ++it)
+            {
+                if (*it->second == *table) shared = it->second;
+            }
+            if (!shared && table->MemorySize() <= aBudget)
+            {
+                aBudget -= table->MemorySize();
+                aTables.insert(std::make_pair(table->Hash(), table));
+                shared = table;
+            }
+            if (shared)
+            {
+                mpTable = shared;
+                mAssignment = 0;
+                mUndefinedInputs = 0;
+                for (int i = 0; i < int(mInputs.size()); i++)
+                {
+                    uint32_t bit = uint32_t(1) << (mInputs.size() - 1 - i);
+                    if (mInputs[i] == LOGIC_HIGH) mAssignment |= bit;
+                    if (mInputs[i] == LOGIC_UNDEFINED) mUndefinedInputs |= bit;
+                }
+                for (int i = 0; i < int(mOutputs.size()); i++)
+                {
+                    DriveOutput(i, mpTable->GetOutput(i, mAssignment, mUndefinedInputs));
+                }
+                return 1;
+            }
+        }
+    }
+
+    // Too wide, looped, sequential or over budget: try the circuits inside
+    int collapsed = 0;
+    for (std::pair<std::string, CLogic*> p : mLogics)
+    {
+        CCircuit* circuit = dynamic_cast<CCircuit*>(p.second);
+        if (circuit != NULL) collapsed += circuit->CollapseWith(aMaxInputs, aBudget, aTables);
+    }
+    return collapsed;
+}
+
+void CCircuit::Expand()
+{
+    if (!mpTable) return;
+    mpTable.reset();
+    ComputeOutput();
+}
+
+std::vector<std::string> CCircuit::UnsettledWires()
+{
+    std::vector<std::string> names;
+    for (std::pair<std::string, CWire*> p : mWires)
+    {
+        if (!p.second->IsSettled()) names.push_back(p.first);
+    }
+    for (std::pair<std::string, CLogic*> p : mLogics)
+    {
+        CCircuit* circuit = dynamic_cast<CCircuit*>(p.second);
+        if (circuit == NULL) continue;
+        for (std::string name : circuit->UnsettledWires()) names.push_back(p.first + "." + name);
+    }
+    return names;
+}
+
+void CCircuit::Flatten(CNetlist &aNetlist, const std::string &aPrefix,
+                       const std::vector<int> &aInputNets, const std::vector<int> &aOutputNets)
+{
+    // Reverse lookups from pointers to names
+    std::unordered_map<CLogic*, std::string> logicNames;
+    for (std::pair<std::string, CLogic*> p : mLogics) logicNames[p.second] = p.first;
+
+    // Allocate the net carrying each logic output. Outputs mapped to a circuit output use the net 
+    // the caller allocated for it, any further mapping of the same output is joined with a buffer.
+    std::unordered_map<std::string, std::vector<int>> outputNets;
+    for (std::pair<std::string, CLogic*> p : mLogics)
+    {
+        outputNets[p.first] = std::vector<int>(p.second->OutputSize(), -1);
+    }
     for (std::tuple<std::string, int, int> t : outputMap)
     {
-        eLogicLevel output = mLogics[std::get<0>(t)]->GetOutputState(std::get<1>(t));
-        mOutputs[std::get<2>(t)] = output;
-        if (mpOutputConnections[std::get<2>(t)] != NULL)
+        // A mapping naming a missing logic or output is skipped, leaving the circuit output 
+        // undriven at LOGIC_UNDEFINED as it is when simulated
+        std::unordered_map<std::string, std::vector<int>>::iterator it = outputNets.find(std::get<0>(t));
+        if (it == outputNets.end() || std::get<1>(t) < 0 || std::get<1>(t) >= int(it->second.size())) continue;
+        int &net = it->second[std::get<1>(t)];
+        int circuitNet = aOutputNets[std::get<2>(t)];
+        if (net < 0) net = circuitNet;
+        else aNetlist.AddGate(GATE_BUF, net, -1, circuitNet);
+    }
+    for (std::pair<const std::string, std::vector<int>> &p : outputNets)
+    {
+        for (int i = 0; i < int(p.second.size()); i++)
+        {
+            std::string name = aPrefix + p.first + ":" + std::to_string(i);
+            if (p.second[i] < 0) p.second[i] = aNetlist.AddNet(name);
+            else aNetlist.NameNet(p.second[i], name);
+        }
+    }
+
+    // Resolve the net on each wire: its driving logic output, else a circuit input, else a new 
+    // undriven net that stays at LOGIC_UNDEFINED
+    std::unordered_map<CWire*, int> wireNets;
+    for (std::tuple<int, std::string> t : inputMap)
+    {
+        std::unordered_map<std::string, CWire*>::iterator it = mWires.find(std::get<1>(t));
+        if (it != mWires.end()) wireNets[it->second] = aInputNets[std::get<0>(t)];
+    }
+    for (std::pair<std::string, CLogic*> p : mLogics)
+    {
+        for (int i = 0; i < p.second->OutputSize(); i++)
+        {
+            CWire* wire = p.second->GetOutputConnection(i);
+            if (wire != NULL) wireNets[wire] = outputNets[p.first][i];
+        }
+    }
+    for (std::pair<std::string, CWire*> p : mWires)
+    {
+        std::unordered_map<CWire*, int>::iterator it = wireNets.find(p.second);
+        if (it == wireNets.end()) wireNets[p.second] = aNetlist.AddNet(aPrefix + p.first);
+        else aNetlist.NameNet(it->second, aPrefix + p.first);
+    }
+
+    // Collect the net driving each logic input. Unconnected inputs share one undriven net.
+    int undrivenNet = -1;
+    std::unordered_map<std::string, std::vector<int>> inputNets;
+    for (std::pair<std::string, CLogic*> p : mLogics)
+    {
+        inputNets[p.first] = std::vector<int>(p.second->InputSize(), -1);
+    }
+    for (std::pair<std::string, CWire*> p : mWires)
+    {
+        for (int i = 0; i < p.second->OutputConnectionSize(); i++)
+        {
+            std::string logic = logicNames[p.second->GetConnectedLogic(i)];
+            inputNets[logic][p.second->GetConnectedInput(i)] = wireNets[p.second];
+        }
+    }
+
+    // Flatten each logic element
+    for (std::pair<std::string, CLogic*> p : mLogics)
+    {
+        std::vector<int> &nets = inputNets[p.first];
+        for (int &net : nets)
         {
-            mpOutputConnections[std::get<2>(t)]->DriveLevel(output);
+            if (net >= 0) continue;
+            if (undrivenNet < 0) undrivenNet = aNetlist.AddNet();
+            net = undrivenNet;
         }
+        p.second->Flatten(aNetlist, aPrefix + p.first + ".", nets, outputNets[p.first]);
     }
 }
@@ -3,15 +3,22 @@
 
 //--Includes-------------------------------------------------------------------
 #include "CLogic.h"
+#include "CTruthTable.h"
 
 #include <vector>
 #include <unordered_map>
 #include <tuple>
 #include <string>
+#include <memory>
+#include <cstdint>
 
 //---CCircuit Declaration-------------------------------------------------------
 // Subclass of CLogic, providing functionality to build combinatorial circuits using CCircuit or 
 // CGate objects.
+//
+// A collapsed circuit answers input changes with one CTruthTable lookup instead of propagating
+// through its contents, whose wires keep their levels from before it collapsed. Any edit of the
+// circuit expands it again, bringing its contents up to date.
 class CCircuit: public CLogic
 {
 public:
@@ -51,6 +58,33 @@ public:
     */
     void AddLogic(std::string logic, CLogic* clogic);
 
+    /**
+     * Remove logic element from this CLogic instance, deleting it. Wires it drove are left at
+     * LOGIC_UNDEFINED, as are circuit outputs mapped to it.
+     * 
+     * @param logic name of logic element
+    */
+    void RemoveLogic(std::string logic);
+
+    /**
+     * Replace logic element with another taking the same inputs and outputs, deleting the old
+     * one. The new element takes over the old one's wires and input levels, and only the logic
+     * its outputs drive is recomputed.
+     * 
+     * @param logic name of logic element
+     * @param clogic pointer to new logic element
+    */
+    void ReplaceLogic(std::string logic, CLogic* clogic);
+
+    /**
+     * Disconnect wire from input of logic element, leaving the input at LOGIC_UNDEFINED
+     * 
+     * @param wire wire to disconnect from
+     * @param logic gate to disconnect
+     * @param input input of gate to disconnect
+    */
+    void DisconnectWireFromLogic(std::string wire, std::string logic, int input);
+
     /**
      * Add wire to this CLogic instance
      * 
@@ -66,6 +100,14 @@ public:
     */
     void MapInput(std::string wire, int circuitInput = -1);
 
+    /**
+     * Drive a circuit input, driving only the wires mapped to it
+     * 
+     * @param aInputIndex input number
+     * @param aNewLevel level to drive input
+    */
+    void DriveInput(int aInputIndex, eLogicLevel aNewLevel);
+
     /**
      * Connect the output of logic element to circuit output
      * 
@@ -75,17 +117,108 @@ public:
     */
     void MapOutput(std::string logic, int logicOutput, int circuitOutput = -1);
 
+    /**
+     * return names of the wires, in this circuit and every circuit nested inside it, that were
+     * still changing when propagation gave up on them. Nested names are {logicName}.{wireName}.
+    */
+    std::vector<std::string> UnsettledWires();
+
+    /**
+     * Drive the circuit outputs mapped to a logic element's output when it changes
+     * 
+     * @param apChild logic element whose output changed
+     * @param aOutputIndex output number of the element
+    */
+    void ChildOutputChanged(CLogic *apChild, int aOutputIndex);
+
+    /**
+     * Sample the inputs of every flip-flop in this circuit and the circuits nested inside it
+    */
+    void ClockSample();
+
+    /**
+     * Drive the outputs of every flip-flop in this circuit and the circuits nested inside it
+    */
+    void ClockCommit();
+
+    /**
+     * Collapse this circuit into a truth table if it has few enough inputs, no combinational
+     * loops and no flip-flops, otherwise collapse the circuits nested inside it. Circuits with
+     * the same response share one table, and tables are built until their memory reaches a
+     * budget. Collapse again after editing a nested circuit directly.
+     * 
+     * @param aMaxInputs most inputs of a collapsed circuit, at most 20
+     * @param aBudget most bytes of table memory to build
+     * @return number of circuits collapsed
+    */
+    int Collapse(int aMaxInputs = 12, size_t aBudget = 1 << 20);
+
+    /**
+     * return whether this circuit evaluates by truth table
+    */
+    bool IsCollapsed();
+
+    /**
+     * Append this circuit, and every circuit nested inside it, to a flattened netlist
+     * 
+     * Wires become nets named {aPrefix}{wireName}, gate outputs become nets named
+     * {aPrefix}{logicName}:{output} and nested circuits are flattened with the prefix
+     * {aPrefix}{logicName}.
+     * 
+     * @param aNetlist netlist to append to
+     * @param aPrefix hierarchical name prefix for nets inside this circuit
+     * @param aInputNets net driving each circuit input
+     * @param aOutputNets net carrying each circuit output
+    */
+    void Flatten(CNetlist &aNetlist, const std::string &aPrefix,
+                 const std::vector<int> &aInputNets, const std::vector<int> &aOutputNets);
+
 private:
     /**
      * Compute the output levels of this Clogic object
     */
     void ComputeOutput();
 
+    /**
+     * Make a logic output drive the circuit output mapped to it, if the logic has been added
+     * 
+     * @param mapping output mapping
+    */
+    void TapOutput(std::tuple<std::string, int, int> mapping);
+
+    /**
+     * Rebuild the output taps from the output mapping and drive every circuit output
+    */
+    void UpdateOutputs();
+
+    /**
+     * Collapse, sharing tables of the same response across the circuits collapsed
+     * 
+     * @param aMaxInputs most inputs of a collapsed circuit
+     * @param aBudget bytes of table memory left, reduced by each table built
+     * @param aTables tables built so far, by hash
+     * @return number of circuits collapsed
+    */
+    int CollapseWith(int aMaxInputs, size_t &aBudget,
+                     std::unordered_multimap<size_t, std::shared_ptr<const CTruthTable>> &aTables);
+
+    /**
+     * Stop evaluating by truth table, driving the contents with the current inputs
+    */
+    void Expand();
+
     std::unordered_map<std::string, CLogic*> mLogics;                 // gate pointers
     std::unordered_map<std::string, CWire*> mWires;                   // wire pointers
 
     std::vector<std::tuple<int, std::string>> inputMap;               // input mapping
+    std::vector<std::vector<std::string>> inputWires;                 // wires of each input
     std::vector<std::tuple<std::string, int, int>> outputMap;         // output mapping
+    std::unordered_map<CLogic*, std::vector<std::pair<int, int>>> outputTaps;  // logic and circuit 
+                                                                      // output of each mapping
+    int untappedOutputs;                                              // mappings to logic not yet added
+    std::shared_ptr<const CTruthTable> mpTable;                       // response while collapsed, or NULL
+    uint32_t mAssignment;                                             // input levels, in table order
+    uint32_t mUndefinedInputs;                                        // inputs at LOGIC_UNDEFINED
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,66 @@
+// See CDFFGate.h
+//
+//--Includes-------------------------------------------------------------------
+#include "CDFFGate.h"
+#include "CNetlist.h"
+
+//---CDFFGate Implementation--------------------------------------------------
+CDFFGate::CDFFGate(bool aEnable, bool aReset) : CLogic()
+{
+    mEnableInput = aEnable ? 1 : -1;
+    mResetInput = aReset ? (aEnable ? 2 : 1) : -1;
+    mInputs = std::vector<eLogicLevel>(1 + int(aEnable) + int(aReset), LOGIC_UNDEFINED);
+    mOutputs = std::vector<eLogicLevel>(nOutputs, LOGIC_LOW);
+    mpOutputConnections = std::vector<CWire*>(nOutputs, NULL);
+    mSampled = LOGIC_LOW;
+}
+
+void CDFFGate::ComputeOutput(){}
+
+void CDFFGate::ClockSample()
+{
+    eLogicLevel enable = (mEnableInput >= 0) ? mInputs[mEnableInput] : LOGIC_HIGH;
+    eLogicLevel reset = (mResetInput >= 0) ? mInputs[mResetInput] : LOGIC_LOW;
+
+    // Enable picks D or the current state
+    eLogicLevel loaded;
+    if (enable == LOGIC_HIGH)
+    {
+        loaded = mInputs[0];
+    }
+    else if (enable == LOGIC_LOW || mInputs[0] == mOutputs[0])
+    {
+        loaded = mOutputs[0];
+    }
+    else
+    {
+        loaded = LOGIC_UNDEFINED;
+    }
+
+    // Reset overrides it with LOW
+    if (reset == LOGIC_HIGH)
+    {
+        mSampled = LOGIC_LOW;
+    }
+    else if (reset == LOGIC_LOW || loaded == LOGIC_LOW)
+    {
+        mSampled = loaded;
+    }
+    else
+    {
+        mSampled = LOGIC_UNDEFINED;
+    }
+}
+
+void CDFFGate::ClockCommit()
+{
+    // Drive output if it changed
+    DriveOutput(0, mSampled);
+}
+
+void CDFFGate::Flatten(CNetlist &aNetlist, const std::string &,
+                       const std::vector<int> &aInputNets, const std::vector<int> &aOutputNets)
+{
+    aNetlist.AddFlop(aInputNets[0], (mEnableInput >= 0) ? aInputNets[mEnableInput] : -1,
+                     (mResetInput >= 0) ? aInputNets[mResetInput] : -1, aOutputNets[0]);
+}
@@ -0,0 +1,60 @@
+#ifndef _CDFFGATE_H
+#define _CDFFGATE_H
+
+//--Includes-------------------------------------------------------------------
+#include "CLogic.h"
+
+//---CDFFGate Declaration-------------------------------------------------------
+// Subclass of CLogic that simulates a rising edge D flip-flop with optional enable and
+// synchronous reset
+//
+// Inputs are D, then enable if present, then reset if present. The output powers up LOW and
+// only changes when the flip-flop is clocked: reset HIGH loads LOW, otherwise enable HIGH loads D
+// and enable LOW holds the state. An undefined enable or reset loads LOGIC_UNDEFINED unless
+// both choices give the same level.
+class CDFFGate: public CLogic
+{
+public:
+    /**
+     * Constructor
+     * 
+     * @param aEnable whether the flip-flop has an enable input
+     * @param aReset whether the flip-flop has a reset input
+    */
+    CDFFGate(bool aEnable = false, bool aReset = false);
+
+    /**
+     * Sample the inputs at a clock edge
+    */
+    void ClockSample();
+
+    /**
+     * Drive the output with the level sampled
+    */
+    void ClockCommit();
+
+    /**
+     * Append this flip-flop to a flattened netlist
+     * 
+     * @param aNetlist netlist to append to
+     * @param aPrefix hierarchical name prefix (unused by gates)
+     * @param aInputNets net driving each input
+     * @param aOutputNets net carrying each output
+    */
+    void Flatten(CNetlist &aNetlist, const std::string &aPrefix,
+                 const std::vector<int> &aInputNets, const std::vector<int> &aOutputNets);
+
+private:
+    /**
+     * Compute the output levels of this Clogic object. Outputs only change at a clock edge.
+    */
+    void ComputeOutput();
+
+    static const int nOutputs = 1;      // number of outputs for a flip-flop
+
+    int mEnableInput;                   // input number of the enable, or -1
+    int mResetInput;                    // input number of the reset, or -1
+    eLogicLevel mSampled;               // level sampled at the last clock edge
+};
+
+#endif
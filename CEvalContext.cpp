@@ -0,0 +1,74 @@
+// See CEvalContext.h
+//
+//--Includes-------------------------------------------------------------------
+#include "CEvalContext.h"
+#include "CNetlist.h"
+
+//---CEvalContext Implementation-----------------------------------------------
+CEvalContext::CEvalContext(const CNetlist &aNetlist)
+{
+    mNets = std::vector<eLogicLevel>(aNetlist.NetSize(), LOGIC_UNDEFINED);
+    mWords = std::vector<LogicWord>(aNetlist.NetSize());
+    Reset();
+}
+
+void CEvalContext::Resize(size_t aNets)
+{
+    LogicWord undefined;
+    undefined.mHigh = 0;
+    undefined.mUndefined = ~uint64_t(0);
+    mNets.resize(aNets, LOGIC_UNDEFINED);
+    mWords.resize(aNets, undefined);
+}
+
+void CEvalContext::ResizeBlocks(size_t aNets)
+{
+    LogicBlock undefined;
+    for (int w = 0; w < LogicBlock::Words; w++)
+    {
+        undefined.mHigh[w] = 0;
+        undefined.mUndefined[w] = ~uint64_t(0);
+    }
+    mBlocks.resize(aNets, undefined);
+}
+
+void CEvalContext::Reset()
+{
+    mEditsSeen = ~size_t(0);
+    mUnsettled.clear();
+    mFlops.clear();
+    mFlopWords.clear();
+    mFlopBlocks.clear();
+    for (eLogicLevel &level : mNets) level = LOGIC_UNDEFINED;
+    for (LogicWord &word : mWords)
+    {
+        word.mHigh = 0;
+        word.mUndefined = ~uint64_t(0);
+    }
+    mBlocks.clear();
+}
+
+eLogicLevel CEvalContext::GetNetLevel(int aNet) const
+{
+    return mNets[aNet];
+}
+
+const LogicWord& CEvalContext::GetNetWord(int aNet) const
+{
+    return mWords[aNet];
+}
+
+eLogicLevel CEvalContext::GetFlopLevel(int aFlop) const
+{
+    return mFlops[aFlop];
+}
+
+const LogicBlock& CEvalContext::GetNetBlock(int aNet) const
+{
+    return mBlocks[aNet];
+}
+
+const std::vector<int>& CEvalContext::UnsettledNets() const
+{
+    return mUnsettled;
+}
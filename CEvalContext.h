@@ -0,0 +1,117 @@
+#ifndef _CEVALCONTEXT_H
+#define _CEVALCONTEXT_H
+
+//--Includes-------------------------------------------------------------------
+#include "CWire.h"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+//--Forward Declaration
+class CNetlist;
+
+//--Consts and enums-----------------------------------------------------------
+// 64 logic levels packed one per bit, for evaluating 64 input patterns at once. Bit i is 
+// LOGIC_UNDEFINED if set in mUndefined, else LOGIC_HIGH if set in mHigh, else LOGIC_LOW.
+struct LogicWord
+{
+    uint64_t mHigh;             // bits at LOGIC_HIGH
+    uint64_t mUndefined;        // bits at LOGIC_UNDEFINED
+};
+
+// 512 logic levels as bit-planes of Words words each, for the vector kernels of 
+// CNetlist::EvaluateBlocks. Pattern p is bit (p % 64) of word (p / 64), with the same encoding as
+// LogicWord. Aligned so one plane fills one 512 bit register or two 256 bit registers.
+struct alignas(64) LogicBlock
+{
+    static const int Words = 8;         // words per bit-plane
+    uint64_t mHigh[Words];              // bits at LOGIC_HIGH
+    uint64_t mUndefined[Words];         // bits at LOGIC_UNDEFINED
+};
+
+//---CEvalContext Declaration---------------------------------------------------
+// CEvalContext holds the signal level of every net of a CNetlist
+//
+// A context is the only state touched while evaluating a netlist. Each thread evaluating a shared
+// netlist owns one, so memory grows with threads x nets rather than threads x netlists.
+class CEvalContext
+{
+public:
+    /**
+     * Constructor, with every net LOGIC_UNDEFINED
+     *
+     * @param aNetlist netlist this context holds levels for
+    */
+    CEvalContext(const CNetlist &aNetlist);
+
+    /**
+     * Set every net back to LOGIC_UNDEFINED and every flip-flop back to its initial level
+    */
+    void Reset();
+
+    /**
+     * return level of a net after the last evaluation
+     *
+     * @param aNet net number
+    */
+    eLogicLevel GetNetLevel(int aNet) const;
+
+    /**
+     * return levels of a net after the last 64 pattern evaluation
+     *
+     * @param aNet net number
+    */
+    const LogicWord& GetNetWord(int aNet) const;
+
+    /**
+     * return levels of a net after the last 512 pattern evaluation
+     *
+     * @param aNet net number
+    */
+    const LogicBlock& GetNetBlock(int aNet) const;
+
+    /**
+     * return state of a flip-flop, its initial level until the netlist is first evaluated
+     *
+     * @param aFlop flip-flop number
+    */
+    eLogicLevel GetFlopLevel(int aFlop) const;
+
+    /**
+     * return nets of combinational loops that had not settled when the last evaluation gave up
+     * on them, and were left LOGIC_UNDEFINED
+    */
+    const std::vector<int>& UnsettledNets() const;
+
+private:
+    friend class CNetlist;
+
+    /**
+     * Resize to a netlist that gained nets, new nets starting LOGIC_UNDEFINED
+     *
+     * @param aNets number of nets
+    */
+    void Resize(size_t aNets);
+
+    /**
+     * Resize the 512 pattern levels, allocated only once a netlist evaluates blocks, new nets
+     * starting LOGIC_UNDEFINED
+     *
+     * @param aNets number of nets
+    */
+    void ResizeBlocks(size_t aNets);
+
+    std::vector<eLogicLevel> mNets;         // level of each net
+    std::vector<LogicWord> mWords;          // 64 pattern levels of each net
+    std::vector<LogicBlock> mBlocks;        // 512 pattern levels of each net, empty until used
+    size_t mEditsSeen;                      // netlist edits included in mNets, past the end if never evaluated
+    std::vector<char> mQueued;              // gates queued for CNetlist::Reevaluate
+    std::vector<int> mUnsettled;            // loop nets left unsettled by the last evaluation
+    std::vector<LogicWord> mLoopWords;      // loop outputs before settling, for recording
+    std::vector<eLogicLevel> mFlops;        // state of each flip-flop, empty until first evaluated
+    std::vector<LogicWord> mFlopWords;      // 64 pattern states of each flip-flop, likewise
+    std::vector<LogicBlock> mFlopBlocks;    // 512 pattern states of each flip-flop, likewise
+};
+
+#endif
@@ -4,15 +4,18 @@
 #include "CLogic.h"
 
 //---CLogic Implementation--------------------------------------------------
-CLogic::CLogic(){}
+CLogic::CLogic()
+{
+    mpParent = NULL;
+}
 
 CLogic::~CLogic(){}
 
 void CLogic::ConnectOutput(int aOutputIndex, CWire *apOutputConnection)
 {
-    // Connect new output and recompute outputs
+    // Connect new output and drive it with the current level
     mpOutputConnections[aOutputIndex] = apOutputConnection;
-    ComputeOutput();
+    if (apOutputConnection != NULL) apOutputConnection->DriveLevel(GetOutputState(aOutputIndex));
 }
 
 void CLogic::DriveInput(int aInputIndex, eLogicLevel aNewLevel)
@@ -22,6 +25,11 @@ void CLogic::DriveInput(int aInputIndex, eLogicLevel aNewLevel)
     ComputeOutput();
 }
 
+eLogicLevel CLogic::GetInputState(int aInputIndex)
+{
+    return mInputs[aInputIndex];
+}
+
 eLogicLevel CLogic::GetOutputState(int aOutputIndex)
 {
     // Resize outputs to required index
@@ -41,4 +49,36 @@ int CLogic::InputSize()
 int CLogic::OutputSize()
 {
     return mOutputs.size();
+}
+
+CWire* CLogic::GetOutputConnection(int aOutputIndex)
+{
+    if (aOutputIndex >= int(mpOutputConnections.size())) return NULL;
+    return mpOutputConnections[aOutputIndex];
+}
+
+void CLogic::SetParent(CLogic *apParent)
+{
+    mpParent = apParent;
+}
+
+void CLogic::ChildOutputChanged(CLogic *, int){}
+
+void CLogic::Clock()
+{
+    ClockSample();
+    ClockCommit();
+}
+
+void CLogic::ClockSample(){}
+
+void CLogic::ClockCommit(){}
+
+void CLogic::DriveOutput(int aOutputIndex, eLogicLevel aNewLevel)
+{
+    // Unchanged levels stop here, which is what lets propagation through loops settle
+    if (mOutputs[aOutputIndex] == aNewLevel) return;
+    mOutputs[aOutputIndex] = aNewLevel;
+    if (mpOutputConnections[aOutputIndex] != NULL) mpOutputConnections[aOutputIndex]->DriveLevel(aNewLevel);
+    if (mpParent != NULL) mpParent->ChildOutputChanged(this, aOutputIndex);
 }
\ No newline at end of file
@@ -5,6 +5,11 @@
 #include "CWire.h"
 
 #include <vector>
+#include <string>
+#include <cstddef>
+
+//--Forward Declaration
+class CNetlist;
 
 //---Logic Declaration-------------------------------------------------------
 // CLogic is a template class used to represent logic cells (i.e. gates or subcircuits)
@@ -35,7 +40,14 @@ class CLogic
      * @param aInputIndex input number
      * @param aNewLevel level to drive input
     */
-    void DriveInput(int aInputIndex, eLogicLevel aNewLevel);
+    virtual void DriveInput(int aInputIndex, eLogicLevel aNewLevel);
+
+    /**
+     * return current level of an input of this logic element
+     * 
+     * @param aInputIndex input number
+    */
+    eLogicLevel GetInputState(int aInputIndex);
 
     /**
      * return current output level of this logic element
@@ -58,6 +70,60 @@ class CLogic
     */
     int OutputSize();
 
+    /**
+     * return wire connected to an output of this logic element
+     * 
+     * @param aOutputIndex output number
+     * @return connected wire, or NULL if the output is unconnected
+    */
+    CWire* GetOutputConnection(int aOutputIndex);
+
+    /**
+     * Set the circuit told when an output of this logic element changes
+     * 
+     * @param apParent circuit containing this element, or NULL
+    */
+    void SetParent(CLogic *apParent);
+
+    /**
+     * Called when an output of a contained logic element changes. Does nothing unless overridden.
+     * 
+     * @param apChild logic element whose output changed
+     * @param aOutputIndex output number of the element
+    */
+    virtual void ChildOutputChanged(CLogic *apChild, int aOutputIndex);
+
+    /**
+     * Clock this logic element once: every flip-flop inside it samples its inputs, then every
+     * flip-flop drives its output, so none sees another's new level within the same edge.
+    */
+    void Clock();
+
+    /**
+     * First phase of a clock edge: sample flip-flop inputs. Does nothing unless overridden.
+    */
+    virtual void ClockSample();
+
+    /**
+     * Second phase of a clock edge: drive flip-flop outputs with the levels sampled. Does 
+     * nothing unless overridden.
+    */
+    virtual void ClockCommit();
+
+    /**
+     * Pure virtual function
+     * 
+     * Append this logic element to a flattened netlist. The caller allocates the nets carrying
+     * every input and output, this element only adds the gates connecting them.
+     * 
+     * @param aNetlist netlist to append to
+     * @param aPrefix hierarchical name prefix for nets inside this element
+     * @param aInputNets net driving each input
+     * @param aOutputNets net carrying each output
+    */
+    virtual void Flatten(CNetlist &aNetlist, const std::string &aPrefix,
+                         const std::vector<int> &aInputNets, const std::vector<int> &aOutputNets) = 0;
+
   protected:
 
     /**
@@ -67,9 +133,18 @@ class CLogic
     */
     virtual void ComputeOutput() = 0;
 
+    /**
+     * Set an output level. If it changed, drive the connected wire and tell the parent.
+     * 
+     * @param aOutputIndex output number
+     * @param aNewLevel new output level
+    */
+    void DriveOutput(int aOutputIndex, eLogicLevel aNewLevel);
+
     std::vector<eLogicLevel> mInputs;            // Input levels
     std::vector<eLogicLevel> mOutputs;           // Output levels
     std::vector<CWire*> mpOutputConnections;     // Output wires
+    CLogic *mpParent;                            // Circuit told of output changes, or NULL
 };
 
 #endif
\ No newline at end of file
@@ -2,6 +2,7 @@
 //
 //--Includes-------------------------------------------------------------------
 #include "CNOTGate.h"
+#include "CNetlist.h"
 
 //---CNOTGate Implementation--------------------------------------------------
 CNOTGate::CNOTGate() : CLogic()
@@ -15,18 +16,25 @@ CNOTGate::CNOTGate() : CLogic()
 void CNOTGate::ComputeOutput()
 {
     // NOT logic
+    eLogicLevel output;
     if (mInputs[0] == LOGIC_HIGH)
     {
-        mOutputs[0] = LOGIC_LOW;
+        output = LOGIC_LOW;
     }
     else if (mInputs[0] == LOGIC_LOW)
     {
-        mOutputs[0] = LOGIC_HIGH;
+        output = LOGIC_HIGH;
     }
     else 
     {
-        mOutputs[0] = LOGIC_UNDEFINED;
+        output = LOGIC_UNDEFINED;
     }
-    // Drive output
-    if (mpOutputConnections[0] != NULL) mpOutputConnections[0]->DriveLevel(mOutputs[0]);
+    // Drive output if it changed
+    DriveOutput(0, output);
+}
+
+void CNOTGate::Flatten(CNetlist &aNetlist, const std::string &,
+                       const std::vector<int> &aInputNets, const std::vector<int> &aOutputNets)
+{
+    aNetlist.AddGate(GATE_NOT, aInputNets[0], -1, aOutputNets[0]);
 }
\ No newline at end of file
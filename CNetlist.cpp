@@ -0,0 +1,1645 @@
+// See CNetlist.h
+//
+//--Includes-------------------------------------------------------------------
+#include "CNetlist.h"
+#include "CToggleAnalyzer.h"
+
+#include <iostream>
+#include <algorithm>
+#include <queue>
+
+
+//---Gate evaluation------------------------------------------------------------
+// Same rules as the CGate classes: any undefined input gives an undefined output. Every kernel
+// passes a gate without a second input its first input twice, which single input operations
+// ignore; two input gates always have both, as AddGate, ReplaceGate and ReconnectInput ensure.
+static inline eLogicLevel ComputeGate(eGateOp aOp, eLogicLevel aIn0, eLogicLevel aIn1)
+{
+    switch (aOp)
+    {
+    case GATE_NOT:
+        if (aIn0 == LOGIC_UNDEFINED) return LOGIC_UNDEFINED;
+        return (aIn0 == LOGIC_HIGH) ? LOGIC_LOW : LOGIC_HIGH;
+    case GATE_BUF:
+        return aIn0;
+    default:
+        break;
+    }
+    if (aIn0 == LOGIC_UNDEFINED || aIn1 == LOGIC_UNDEFINED) return LOGIC_UNDEFINED;
+    switch (aOp)
+    {
+    case GATE_AND:
+        return (aIn0 == LOGIC_HIGH && aIn1 == LOGIC_HIGH) ? LOGIC_HIGH : LOGIC_LOW;
+    case GATE_OR:
+        return (aIn0 == LOGIC_HIGH || aIn1 == LOGIC_HIGH) ? LOGIC_HIGH : LOGIC_LOW;
+    default:
+        return (aIn0 != aIn1) ? LOGIC_HIGH : LOGIC_LOW;
+    }
+}
+
+// Bitwise version of ComputeGate, evaluating 64 levels at once. Each operation is a truth table
+// over the defined input levels, selected with masks so that mixed gate types do not branch.
+static const uint64_t GateTables[][4] = {
+    //  in0 LOW in1 LOW   in0 HIGH in1 LOW  in0 LOW in1 HIGH  in0 HIGH in1 HIGH
+    {   0,                0,                0,                ~uint64_t(0)  },    // GATE_AND
+    {   0,                ~uint64_t(0),     ~uint64_t(0),     ~uint64_t(0)  },    // GATE_OR
+    {   0,                ~uint64_t(0),     ~uint64_t(0),     0             },    // GATE_XOR
+    {   ~uint64_t(0),     0,                ~uint64_t(0),     0             },    // GATE_NOT
+    {   0,                ~uint64_t(0),     0,                ~uint64_t(0)  }     // GATE_BUF
+};
+
+static inline LogicWord ComputeGateWord(eGateOp aOp, const LogicWord &aIn0, const LogicWord &aIn1)
+{
+    const uint64_t *table = GateTables[aOp];
+    LogicWord out;
+    out.mUndefined = aIn0.mUndefined | aIn1.mUndefined;
+    out.mHigh = ((table[0] & ~aIn0.mHigh & ~aIn1.mHigh) | (table[1] & aIn0.mHigh & ~aIn1.mHigh) |
+                 (table[2] & ~aIn0.mHigh & aIn1.mHigh) | (table[3] & aIn0.mHigh & aIn1.mHigh)) &
+                ~out.mUndefined;
+    return out;
+}
+
+// Lane types of the block kernels, each covering Words words of a bit-plane. The vector types
+// compile to single AVX2 or AVX-512 instructions inside functions built for those targets.
+struct PortableLanes
+{
+    typedef uint64_t Vector;
+    static const int Words = 1;
+};
+
+struct Avx2Lanes
+{
+    typedef uint64_t Vector __attribute__((vector_size(32)));
+    static const int Words = 4;
+};
+
+struct Avx512Lanes
+{
+    typedef uint64_t Vector __attribute__((vector_size(64)));
+    static const int Words = 8;
+};
+
+// Block version of ComputeGateWord, the same operations on every word of the bit-planes
+template <class TLanes>
+__attribute__((always_inline))
+static inline void ComputeGateBlock(eGateOp aOp, const LogicBlock &aIn0, const LogicBlock &aIn1, LogicBlock &aOut)
+{
+    typedef typename TLanes::Vector Vector;
+    const uint64_t *table = GateTables[aOp];
+    for (int w = 0; w < LogicBlock::Words; w += TLanes::Words)
+    {
+        Vector in0 = *(const Vector *)(aIn0.mHigh + w);
+        Vector in1 = *(const Vector *)(aIn1.mHigh + w);
+        Vector undefined = *(const Vector *)(aIn0.mUndefined + w) | *(const Vector *)(aIn1.mUndefined + w);
+        *(Vector *)(aOut.mHigh + w) = ((table[0] & ~in0 & ~in1) | (table[1] & in0 & ~in1) |
+                                       (table[2] & ~in0 & in1) | (table[3] & in0 & in1)) & ~undefined;
+        *(Vector *)(aOut.mUndefined + w) = undefined;
+    }
+}
+
+// One word of a block
+static inline LogicWord BlockWord(const LogicBlock &aBlock, int aWord)
+{
+    LogicWord word;
+    word.mHigh = aBlock.mHigh[aWord];
+    word.mUndefined = aBlock.mUndefined[aWord];
+    return word;
+}
+
+// Next state of a flip-flop at a clock edge. Undefined enable or reset levels give an undefined
+// state unless both choices agree.
+static inline eLogicLevel ComputeFlop(eLogicLevel aQ, eLogicLevel aD, eLogicLevel aEnable, eLogicLevel aReset)
+{
+    eLogicLevel loaded = (aEnable == LOGIC_HIGH) ? aD : (aEnable == LOGIC_LOW || aD == aQ) ? aQ : LOGIC_UNDEFINED;
+    if (aReset == LOGIC_HIGH) return LOGIC_LOW;
+    if (aReset == LOGIC_LOW || loaded == LOGIC_LOW) return loaded;
+    return LOGIC_UNDEFINED;
+}
+
+// Bitwise version of ComputeFlop
+static inline LogicWord ComputeFlopWord(const LogicWord &aQ, const LogicWord &aD, const LogicWord &aEnable,
+                                        const LogicWord &aReset)
+{
+    uint64_t enableHigh = aEnable.mHigh & ~aEnable.mUndefined;
+    uint64_t enableLow = ~aEnable.mHigh & ~aEnable.mUndefined;
+    uint64_t same = ~((aD.mHigh ^ aQ.mHigh) | (aD.mUndefined ^ aQ.mUndefined));
+    LogicWord loaded;
+    loaded.mHigh = (enableHigh & aD.mHigh) | (enableLow & aQ.mHigh) | (aEnable.mUndefined & same & aQ.mHigh);
+    loaded.mUndefined = (enableHigh & aD.mUndefined) | (enableLow & aQ.mUndefined) |
+                        (aEnable.mUndefined & (~same | aQ.mUndefined));
+    uint64_t resetLow = ~aReset.mHigh & ~aReset.mUndefined;
+    uint64_t loadedLow = ~loaded.mHigh & ~loaded.mUndefined;
+    LogicWord next;
+    next.mHigh = resetLow & loaded.mHigh;
+    next.mUndefined = (resetLow & loaded.mUndefined) | (aReset.mUndefined & ~loadedLow);
+    return next;
+}
+
+// Recorder for evaluations that record nothing
+struct NoRecorder
+{
+    inline void Record(int, const LogicWord &, const LogicWord &) {}
+};
+
+// CPU features, checked on first use. __builtin_cpu_supports is only valid once
+// __builtin_cpu_init has run, which is not guaranteed during static initialisation.
+#if defined(__x86_64__) || defined(__i386__)
+static bool HasPopcnt()
+{
+    static const bool popcnt = []() {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("popcnt") != 0;
+    }();
+    return popcnt;
+}
+
+static eKernel BestCpuKernel()
+{
+    static const eKernel best = []() {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return KERNEL_AVX512;
+        if (__builtin_cpu_supports("avx2")) return KERNEL_AVX2;
+        return KERNEL_PORTABLE;
+    }();
+    return best;
+}
+#else
+static eKernel BestCpuKernel()
+{
+    return KERNEL_PORTABLE;
+}
+#endif
+
+//---CNetlist Implementation----------------------------------------------------
+CNetlist::CNetlist()
+{
+    mFinalized = false;
+}
+
+CNetlist::CNetlist(CLogic *apLogic)
+{
+    mFinalized = false;
+
+    // Allocate nets for the element's ports and flatten it between them
+    std::vector<int> inputNets;
+    std::vector<int> outputNets;
+    for (int i = 0; i < apLogic->InputSize(); i++)
+    {
+        inputNets.push_back(AddNet());
+        AddInput(inputNets.back());
+    }
+    for (int i = 0; i < apLogic->OutputSize(); i++)
+    {
+        outputNets.push_back(AddNet());
+        AddOutput(outputNets.back());
+    }
+    apLogic->Flatten(*this, "", inputNets, outputNets);
+    Finalize();
+}
+
+int CNetlist::AddNet(std::string aName)
+{
+    mNetNames.push_back("");
+    NameNet(mNetNames.size() - 1, aName);
+    if (mFinalized)
+    {
+        // New nets start undriven
+        mDrivers.push_back(-1);
+        mFanouts.push_back(std::vector<int>());
+        mUndrivenNets.push_back(mNetNames.size() - 1);
+    }
+    return mNetNames.size() - 1;
+}
+
+void CNetlist::NameNet(int aNet, std::string aName)
+{
+    if (aName.empty()) return;
+    if (mNetNames[aNet].empty()) mNetNames[aNet] = aName;
+    mNetIndex[aName] = aNet;
+}
+
+int CNetlist::AddGate(eGateOp aOp, int aInput0, int aInput1, int aOutput)
+{
+    bool twoInputs = (aOp != GATE_NOT && aOp != GATE_BUF);
+    if (aInput0 < 0 || (twoInputs && aInput1 < 0)) return -1;
+
+    // Remove any driver of the output first, a removal that rebuilds the order must not see the
+    // new gate
+    if (mFinalized && mDrivers[aOutput] >= 0) RemoveGate(mDrivers[aOutput]);
+
+    Gate gate;
+    gate.mOp = aOp;
+    gate.mIn[0] = aInput0;
+    gate.mIn[1] = twoInputs ? aInput1 : -1;
+    gate.mOut = aOutput;
+    mGates.push_back(gate);
+    int g = mGates.size() - 1;
+
+    if (mFinalized)
+    {
+        // Connect the new gate in place of the old driver and place it in its cone
+        mGateLevels.push_back(0);
+        mLevelSlots.push_back(-1);
+        mGateLoops.push_back(-1);
+        for (int net : gate.mIn)
+        {
+            if (net >= 0) mFanouts[net].push_back(g);
+        }
+        SetDriver(aOutput, g);
+        PlaceGate(g, ComputeLevel(g));
+        UpdateLevels(mFanouts[aOutput]);
+        mEdits.push_back(aOutput);
+    }
+    return g;
+}
+
+void CNetlist::AddInput(int aNet)
+{
+    mInputNets.push_back(aNet);
+}
+
+void CNetlist::AddConstant(int aNet, eLogicLevel aLevel)
+{
+    mConstantNets.push_back(aNet);
+    mConstantLevels.push_back(aLevel);
+    if (mFinalized && mDrivers[aNet] < 0)
+    {
+        mUndrivenNets.erase(std::find(mUndrivenNets.begin(), mUndrivenNets.end(), aNet));
+    }
+}
+
+int CNetlist::AddFlop(int aD, int aEnable, int aReset, int aQ, eLogicLevel aInitial)
+{
+    Flop flop;
+    flop.mD = aD;
+    flop.mEnable = aEnable;
+    flop.mReset = aReset;
+    flop.mQ = aQ;
+    flop.mInitial = aInitial;
+    mFlops.push_back(flop);
+    if (mFinalized && mDrivers[aQ] < 0)
+    {
+        std::vector<int>::iterator it = std::find(mUndrivenNets.begin(), mUndrivenNets.end(), aQ);
+        if (it != mUndrivenNets.end()) mUndrivenNets.erase(it);
+    }
+    return mFlops.size() - 1;
+}
+
+void CNetlist::Reserve(int aNets, int aGates)
+{
+    mNetNames.reserve(aNets);
+    mGates.reserve(aGates);
+}
+
+void CNetlist::AddOutput(int aNet)
+{
+    mOutputNets.push_back(aNet);
+}
+
+void CNetlist::Finalize()
+{
+    // Drivers and fanouts of each net. Removed gates have no output net.
+    mDrivers = std::vector<int>(mNetNames.size(), -1);
+    mFanouts = std::vector<std::vector<int>>(mNetNames.size());
+    std::vector<int> fanoutSizes(mNetNames.size(), 0);
+    for (const Gate &gate : mGates)
+    {
+        if (gate.mOut < 0) continue;
+        for (int net : gate.mIn)
+        {
+            if (net >= 0) fanoutSizes[net]++;
+        }
+    }
+    for (int net = 0; net < int(mNetNames.size()); net++) mFanouts[net].reserve(fanoutSizes[net]);
+    for (int g = 0; g < int(mGates.size()); g++)
+    {
+        if (mGates[g].mOut < 0) continue;
+        mDrivers[mGates[g].mOut] = g;
+        for (int net : mGates[g].mIn)
+        {
+            if (net >= 0) mFanouts[net].push_back(g);
+        }
+    }
+    std::vector<bool> isInput(mNetNames.size(), false);
+    for (int net : mInputNets) isInput[net] = true;
+    for (int net : mConstantNets) isInput[net] = true;
+    for (const Flop &flop : mFlops) isInput[flop.mQ] = true;
+    mUndrivenNets.clear();
+    for (int net = 0; net < int(mNetNames.size()); net++)
+    {
+        if (mDrivers[net] < 0 && !isInput[net]) mUndrivenNets.push_back(net);
+    }
+
+    // Strongly connected components of the gate graph, by an iterative Tarjan search so deep 
+    // netlists cannot exhaust the stack. Components complete in reverse topological order.
+    std::vector<int> component(mGates.size(), -1);
+    std::vector<int> members;                           // gates of each component, in completion order
+    std::vector<int> starts;                            // first member of each component
+    members.reserve(mGates.size());
+    starts.reserve(mGates.size() + 1);
+
+    // Gates added in topological order, as the file readers add them, are each a component and
+    // need no search
+    bool ordered = true;
+    for (int g = 0; g < int(mGates.size()) && ordered; g++)
+    {
+        if (mGates[g].mOut < 0) continue;
+        for (int net : mGates[g].mIn)
+        {
+            if (net >= 0 && mDrivers[net] >= g) ordered = false;
+        }
+    }
+    for (int g = int(mGates.size()) - 1; g >= 0 && ordered; g--)
+    {
+        if (mGates[g].mOut < 0) continue;
+        component[g] = starts.size();
+        starts.push_back(members.size());
+        members.push_back(g);
+    }
+
+    std::vector<int> index(ordered ? 0 : mGates.size(), -1);
+    std::vector<int> lowLink(ordered ? 0 : mGates.size(), 0);
+    std::vector<int> open;                              // gates searched but not yet in a component
+    std::vector<std::pair<int, int>> path;              // search path: gate and next fanout to search
+    int searched = 0;
+    for (int root = 0; root < int(mGates.size()) && !ordered; root++)
+    {
+        if (mGates[root].mOut < 0 || index[root] >= 0) continue;
+        index[root] = lowLink[root] = searched++;
+        open.push_back(root);
+        path.push_back(std::make_pair(root, 0));
+        while (!path.empty())
+        {
+            int g = path.back().first;
+            const std::vector<int> &fanout = mFanouts[mGates[g].mOut];
+            if (path.back().second < int(fanout.size()))
+            {
+                int next = fanout[path.back().second++];
+                if (index[next] < 0)
+                {
+                    index[next] = lowLink[next] = searched++;
+                    open.push_back(next);
+                    path.push_back(std::make_pair(next, 0));
+                }
+                else if (component[next] < 0)
+                {
+                    lowLink[g] = std::min(lowLink[g], index[next]);
+                }
+                continue;
+            }
+            path.pop_back();
+            if (!path.empty()) lowLink[path.back().first] = std::min(lowLink[path.back().first], lowLink[g]);
+            if (lowLink[g] != index[g]) continue;
+            starts.push_back(members.size());
+            int member;
+            do
+            {
+                member = open.back();
+                open.pop_back();
+                component[member] = starts.size() - 1;
+                members.push_back(member);
+            } while (member != g);
+        }
+    }
+    starts.push_back(members.size());
+
+    // Level each component in topological order, one above the gates driving it. A component of
+    // more than one gate, or a gate reading its own output, is a loop, placed whole in one level.
+    // Levels are counted before placing so each level's gates take one allocation.
+    mGateLevels = std::vector<int>(mGates.size(), 0);
+    mLevelSlots = std::vector<int>(mGates.size(), -1);
+    mGateLoops = std::vector<int>(mGates.size(), -1);
+    std::vector<char> isLoop(starts.size() - 1, 0);
+    std::vector<int> levelSizes;
+    for (int c = int(starts.size()) - 2; c >= 0; c--)
+    {
+        int level = 0;
+        bool loop = starts[c + 1] - starts[c] > 1;
+        for (int m = starts[c]; m < starts[c + 1]; m++)
+        {
+            for (int net : mGates[members[m]].mIn)
+            {
+                if (net < 0 || mDrivers[net] < 0) continue;
+                if (component[mDrivers[net]] == c) loop = true;
+                else level = std::max(level, mGateLevels[mDrivers[net]] + 1);
+            }
+        }
+        for (int m = starts[c]; m < starts[c + 1]; m++) mGateLevels[members[m]] = level;
+        isLoop[c] = loop;
+        if (level >= int(levelSizes.size())) levelSizes.resize(level + 1, 0);
+        levelSizes[level] += starts[c + 1] - starts[c];
+    }
+    mLevels.clear();
+    mLevels.resize(levelSizes.size());
+    mLoopLevels.assign(levelSizes.size(), 0);
+    mLoops.clear();
+    for (int l = 0; l < int(levelSizes.size()); l++) mLevels[l].reserve(levelSizes[l]);
+    for (int c = int(starts.size()) - 2; c >= 0; c--)
+    {
+        int level = mGateLevels[members[starts[c]]];
+        if (isLoop[c]) mLoops.push_back(std::vector<int>());
+        for (int m = starts[c]; m < starts[c + 1]; m++)
+        {
+            PlaceGate(members[m], level);
+            if (!isLoop[c]) continue;
+            mGateLoops[members[m]] = mLoops.size() - 1;
+            mLoops.back().push_back(members[m]);
+        }
+        if (isLoop[c]) mLoopLevels[level] = 1;
+    }
+
+    mFinalized = true;
+}
+
+void CNetlist::Reorder()
+{
+    if (!mFinalized) Finalize();
+
+    // Rank gates by depth first search over their fanin from each output, then any left over,
+    // so a gate ranks just after the gates driving it
+    std::vector<int> rank(mGates.size(), -1);
+    std::vector<std::pair<int, int>> path;              // search path: gate and next input to search
+    int ranked = 0;
+    auto search = [&](int aRoot) {
+        if (aRoot < 0 || mGates[aRoot].mOut < 0 || rank[aRoot] != -1) return;
+        rank[aRoot] = -2;
+        path.push_back(std::make_pair(aRoot, 0));
+        while (!path.empty())
+        {
+            int g = path.back().first;
+            if (path.back().second < 2)
+            {
+                int net = mGates[g].mIn[path.back().second++];
+                int driver = (net >= 0) ? mDrivers[net] : -1;
+                if (driver >= 0 && rank[driver] == -1)
+                {
+                    rank[driver] = -2;
+                    path.push_back(std::make_pair(driver, 0));
+                }
+                continue;
+            }
+            rank[g] = ranked++;
+            path.pop_back();
+        }
+    };
+    for (int net : mOutputNets) search(mDrivers[net]);
+    for (int g = 0; g < int(mGates.size()); g++) search(g);
+
+    // New gate order: by level, then by rank
+    std::vector<std::pair<std::pair<int, int>, int>> order;
+    for (int g = 0; g < int(mGates.size()); g++)
+    {
+        if (mGates[g].mOut >= 0) order.push_back(std::make_pair(std::make_pair(mGateLevels[g], rank[g]), g));
+    }
+    std::sort(order.begin(), order.end());
+
+    // New net numbers: inputs, constants, gate outputs in the new gate order, then the rest
+    std::vector<int> netMap(mNetNames.size(), -1);
+    std::vector<int> nets;                              // old net of each new net
+    auto number = [&](int aNet) {
+        if (netMap[aNet] >= 0) return;
+        netMap[aNet] = nets.size();
+        nets.push_back(aNet);
+    };
+    for (int net : mInputNets) number(net);
+    for (int net : mConstantNets) number(net);
+    for (const Flop &flop : mFlops) number(flop.mQ);
+    for (const std::pair<std::pair<int, int>, int> &entry : order) number(mGates[entry.second].mOut);
+    for (int net = 0; net < int(mNetNames.size()); net++) number(net);
+
+    // Rebuild in the new numbering
+    std::vector<Gate> gates;
+    gates.reserve(order.size());
+    for (const std::pair<std::pair<int, int>, int> &entry : order)
+    {
+        Gate gate = mGates[entry.second];
+        for (int &net : gate.mIn)
+        {
+            if (net >= 0) net = netMap[net];
+        }
+        gate.mOut = netMap[gate.mOut];
+        gates.push_back(gate);
+    }
+    mGates.swap(gates);
+    std::vector<std::string> names(nets.size());
+    for (int net = 0; net < int(nets.size()); net++) names[net].swap(mNetNames[nets[net]]);
+    mNetNames.swap(names);
+    for (std::pair<const std::string, int> &p : mNetIndex) p.second = netMap[p.second];
+    for (int &net : mInputNets) net = netMap[net];
+    for (int &net : mOutputNets) net = netMap[net];
+    for (int &net : mConstantNets) net = netMap[net];
+    for (Flop &flop : mFlops)
+    {
+        for (int *net : {&flop.mD, &flop.mEnable, &flop.mReset, &flop.mQ})
+        {
+            if (*net >= 0) *net = netMap[*net];
+        }
+    }
+    // Contexts and cones from before hold the old numbering, which no edit list can patch
+    mEdits.push_back(-1);
+    Finalize();
+}
+
+bool CNetlist::ReplaceGate(int aGate, eGateOp aOp, int aInput1)
+{
+    Gate &gate = mGates[aGate];
+    if (gate.mOut < 0) return false;
+    bool twoInputs = (aOp != GATE_NOT && aOp != GATE_BUF);
+    if (aInput1 < 0) aInput1 = twoInputs ? gate.mIn[1] : -1;
+    if (twoInputs && aInput1 < 0) return false;
+    gate.mOp = aOp;
+    mEdits.push_back(gate.mOut);
+
+    // Only a change in the number of inputs moves the gate
+    if (!twoInputs) aInput1 = -1;
+    if (aInput1 != gate.mIn[1]) ReconnectInput(aGate, 1, aInput1);
+    return true;
+}
+
+bool CNetlist::ReconnectInput(int aGate, int aInput, int aNet)
+{
+    Gate &gate = mGates[aGate];
+    if (gate.mOut < 0) return false;
+    bool twoInputs = (gate.mOp != GATE_NOT && gate.mOp != GATE_BUF);
+    if ((aNet < 0) ? (aInput == 0 || twoInputs) : (aInput == 1 && !twoInputs)) return false;
+    if (gate.mIn[aInput] >= 0) EraseFanout(gate.mIn[aInput], aGate);
+    gate.mIn[aInput] = aNet;
+    if (aNet >= 0) mFanouts[aNet].push_back(aGate);
+
+    UpdateLevels(std::vector<int>(1, aGate));
+    mEdits.push_back(gate.mOut);
+    return true;
+}
+
+void CNetlist::ReconnectOutput(int aGate, int aNet)
+{
+    Gate &gate = mGates[aGate];
+    if (gate.mOut < 0 || gate.mOut == aNet) return;
+
+    // The old net is left undriven, the new net loses any other driver
+    int oldNet = gate.mOut;
+    if (mDrivers[aNet] >= 0) RemoveGate(mDrivers[aNet]);
+    SetDriver(oldNet, -1);
+    gate.mOut = aNet;
+    SetDriver(aNet, aGate);
+
+    UpdateLevels(mFanouts[oldNet]);
+    UpdateLevels(mFanouts[aNet]);
+    mEdits.push_back(oldNet);
+    mEdits.push_back(aNet);
+}
+
+void CNetlist::RemoveGate(int aGate)
+{
+    Gate &gate = mGates[aGate];
+    if (gate.mOut < 0) return;
+
+    // Disconnect the gate, leaving its output net undriven
+    int oldNet = gate.mOut;
+    for (int &net : gate.mIn)
+    {
+        if (net >= 0) EraseFanout(net, aGate);
+        net = -1;
+    }
+    UnplaceGate(aGate);
+    SetDriver(oldNet, -1);
+    gate.mOut = -1;
+
+    // Removing a gate of a loop may break it
+    mEdits.push_back(oldNet);
+    if (mGateLoops[aGate] >= 0) Finalize();
+    else UpdateLevels(mFanouts[oldNet]);
+}
+
+int CNetlist::NetDriver(int aNet) const
+{
+    return mDrivers[aNet];
+}
+
+void CNetlist::PlaceGate(int aGate, int aLevel)
+{
+    if (aLevel >= int(mLevels.size()))
+    {
+        mLevels.resize(aLevel + 1);
+        mLoopLevels.resize(aLevel + 1, 0);
+    }
+    mGateLevels[aGate] = aLevel;
+    mLevelSlots[aGate] = mLevels[aLevel].size();
+    mLevels[aLevel].push_back(aGate);
+}
+
+void CNetlist::UnplaceGate(int aGate)
+{
+    // Fill the gate's slot with the last gate of the level
+    std::vector<int> &level = mLevels[mGateLevels[aGate]];
+    int last = level.back();
+    level[mLevelSlots[aGate]] = last;
+    mLevelSlots[last] = mLevelSlots[aGate];
+    level.pop_back();
+    mLevelSlots[aGate] = -1;
+
+    // Drop empty levels from the end
+    while (!mLevels.empty() && mLevels.back().empty())
+    {
+        mLevels.pop_back();
+        mLoopLevels.pop_back();
+    }
+}
+
+int CNetlist::ComputeLevel(int aGate) const
+{
+    int level = 0;
+    for (int net : mGates[aGate].mIn)
+    {
+        if (net >= 0 && mDrivers[net] >= 0 && mGateLevels[mDrivers[net]] + 1 > level)
+        {
+            level = mGateLevels[mDrivers[net]] + 1;
+        }
+    }
+    return level;
+}
+
+void CNetlist::UpdateLevels(const std::vector<int> &aGates)
+{
+    // Raise levels through the fanout cone, stopping wherever a gate is already above its 
+    // drivers. Levels are never lowered, so a removal costs nothing and Finalize makes them tight
+    // again. On an acyclic netlist no level can exceed the gate count, so exceeding it means a 
+    // new loop. Moving a loop, or finding a new one, rebuilds the whole order.
+    std::vector<int> work(aGates);
+    while (!work.empty())
+    {
+        int g = work.back();
+        work.pop_back();
+        if (mGates[g].mOut < 0) continue;
+        int level = ComputeLevel(g);
+        if (level > int(mGates.size()) || mGateLoops[g] >= 0)
+        {
+            Finalize();
+            return;
+        }
+        if (level <= mGateLevels[g] && mLevelSlots[g] >= 0) continue;
+        if (mLevelSlots[g] >= 0) UnplaceGate(g);
+        PlaceGate(g, level);
+        for (int next : mFanouts[mGates[g].mOut]) work.push_back(next);
+    }
+}
+
+void CNetlist::SetDriver(int aNet, int aGate)
+{
+    // Keep the undriven list in step with the driver
+    bool wasUndriven = mDrivers[aNet] < 0;
+    mDrivers[aNet] = aGate;
+    if (IsSourceNet(aNet)) return;
+    if (wasUndriven && aGate >= 0)
+    {
+        mUndrivenNets.erase(std::find(mUndrivenNets.begin(), mUndrivenNets.end(), aNet));
+    }
+    else if (!wasUndriven && aGate < 0)
+    {
+        mUndrivenNets.push_back(aNet);
+    }
+}
+
+bool CNetlist::IsSourceNet(int aNet) const
+{
+    if (std::find(mInputNets.begin(), mInputNets.end(), aNet) != mInputNets.end() ||
+        std::find(mConstantNets.begin(), mConstantNets.end(), aNet) != mConstantNets.end())
+    {
+        return true;
+    }
+    for (const Flop &flop : mFlops)
+    {
+        if (flop.mQ == aNet) return true;
+    }
+    return false;
+}
+
+void CNetlist::EraseFanout(int aNet, int aGate)
+{
+    std::vector<int> &fanout = mFanouts[aNet];
+    std::vector<int>::iterator it = std::find(fanout.begin(), fanout.end(), aGate);
+    if (it != fanout.end()) fanout.erase(it);
+}
+
+void CNetlist::SettleLevel(CEvalContext &aContext, const std::vector<int> &aGates) const
+{
+    // Repeat passes over the level until no output changes. Each pass carries a change at least
+    // one gate further round the loop, so a loop still changing after one pass per gate 
+    // oscillates. A last pass finds the nets still changing and leaves them undefined.
+    eLogicLevel *nets = aContext.mNets.data();
+    const std::vector<int> &gates = aGates;
+    bool changed = true;
+    for (int pass = 0; changed && pass <= int(gates.size()); pass++)
+    {
+        changed = false;
+        for (int g : gates)
+        {
+            const Gate &gate = mGates[g];
+            eLogicLevel in1 = nets[(gate.mIn[1] >= 0) ? gate.mIn[1] : gate.mIn[0]];
+            eLogicLevel out = ComputeGate(gate.mOp, nets[gate.mIn[0]], in1);
+            if (out == nets[gate.mOut]) continue;
+            nets[gate.mOut] = out;
+            changed = true;
+        }
+    }
+    if (!changed) return;
+    for (int g : gates)
+    {
+        const Gate &gate = mGates[g];
+        eLogicLevel in1 = nets[(gate.mIn[1] >= 0) ? gate.mIn[1] : gate.mIn[0]];
+        if (ComputeGate(gate.mOp, nets[gate.mIn[0]], in1) == nets[gate.mOut]) continue;
+        nets[gate.mOut] = LOGIC_UNDEFINED;
+        aContext.mUnsettled.push_back(gate.mOut);
+    }
+}
+
+void CNetlist::Evaluate(CEvalContext &aContext, const std::vector<eLogicLevel> &aInputs,
+                        std::vector<eLogicLevel> &aOutputs) const
+{
+    if (aContext.mNets.size() != mNetNames.size()) aContext.Resize(mNetNames.size());
+    aContext.mEditsSeen = mEdits.size();
+    aContext.mUnsettled.clear();
+    PrepareFlops(aContext);
+    eLogicLevel *nets = aContext.mNets.data();
+
+    // Drive inputs
+    for (int i = 0; i < int(mInputNets.size()); i++)
+    {
+        nets[mInputNets[i]] = (i < int(aInputs.size())) ? aInputs[i] : LOGIC_UNDEFINED;
+    }
+    for (int i = 0; i < int(mConstantNets.size()); i++)
+    {
+        nets[mConstantNets[i]] = mConstantLevels[i];
+    }
+    for (int f = 0; f < int(mFlops.size()); f++)
+    {
+        nets[mFlops[f].mQ] = aContext.mFlops[f];
+    }
+    for (int net : mUndrivenNets)
+    {
+        nets[net] = LOGIC_UNDEFINED;
+    }
+
+    // Compute every gate in level order
+    for (int l = 0; l < int(mLevels.size()); l++)
+    {
+        if (mLoopLevels[l])
+        {
+            SettleLevel(aContext, mLevels[l]);
+            continue;
+        }
+        for (int g : mLevels[l])
+        {
+            const Gate &gate = mGates[g];
+            eLogicLevel in1 = nets[(gate.mIn[1] >= 0) ? gate.mIn[1] : gate.mIn[0]];
+            nets[gate.mOut] = ComputeGate(gate.mOp, nets[gate.mIn[0]], in1);
+        }
+    }
+
+    // Read outputs
+    aOutputs.resize(mOutputNets.size());
+    for (int i = 0; i < int(mOutputNets.size()); i++)
+    {
+        aOutputs[i] = nets[mOutputNets[i]];
+    }
+}
+
+void CNetlist::EvaluateBatch(CEvalContext &aContext, const std::vector<std::vector<eLogicLevel>> &aInputs,
+                             std::vector<std::vector<eLogicLevel>> &aOutputs) const
+{
+    aOutputs.resize(aInputs.size());
+    for (int i = 0; i < int(aInputs.size()); i++)
+    {
+        Evaluate(aContext, aInputs[i], aOutputs[i]);
+    }
+}
+
+template <class TRecorder>
+__attribute__((always_inline))
+inline void CNetlist::EvaluateWordsWith(CEvalContext &aContext, const std::vector<LogicWord> &aInputs,
+                                        std::vector<LogicWord> &aOutputs, TRecorder &aRecorder) const
+{
+    if (aContext.mWords.size() != mNetNames.size()) aContext.Resize(mNetNames.size());
+    aContext.mUnsettled.clear();
+    PrepareFlops(aContext);
+    LogicWord *nets = aContext.mWords.data();
+    LogicWord undefined;
+    undefined.mHigh = 0;
+    undefined.mUndefined = ~uint64_t(0);
+
+    // Drive inputs
+    for (int i = 0; i < int(mInputNets.size()); i++)
+    {
+        LogicWord word = (i < int(aInputs.size())) ? aInputs[i] : undefined;
+        aRecorder.Record(mInputNets[i], nets[mInputNets[i]], word);
+        nets[mInputNets[i]] = word;
+    }
+    for (int i = 0; i < int(mConstantNets.size()); i++)
+    {
+        LogicWord word;
+        word.mHigh = (mConstantLevels[i] == LOGIC_HIGH) ? ~uint64_t(0) : 0;
+        word.mUndefined = (mConstantLevels[i] == LOGIC_UNDEFINED) ? ~uint64_t(0) : 0;
+        aRecorder.Record(mConstantNets[i], nets[mConstantNets[i]], word);
+        nets[mConstantNets[i]] = word;
+    }
+    for (int f = 0; f < int(mFlops.size()); f++)
+    {
+        aRecorder.Record(mFlops[f].mQ, nets[mFlops[f].mQ], aContext.mFlopWords[f]);
+        nets[mFlops[f].mQ] = aContext.mFlopWords[f];
+    }
+    for (int net : mUndrivenNets)
+    {
+        aRecorder.Record(net, nets[net], undefined);
+        nets[net] = undefined;
+    }
+
+    // Compute every gate in level order
+    for (int l = 0; l < int(mLevels.size()); l++)
+    {
+        if (mLoopLevels[l])
+        {
+            SettleLevelWords(aContext, mLevels[l], aRecorder);
+            continue;
+        }
+        for (int g : mLevels[l])
+        {
+            // Single input gates read their input twice, their tables ignore in1
+            const Gate &gate = mGates[g];
+            int in1 = (gate.mIn[1] >= 0) ? gate.mIn[1] : gate.mIn[0];
+            LogicWord out = ComputeGateWord(gate.mOp, nets[gate.mIn[0]], nets[in1]);
+            aRecorder.Record(gate.mOut, nets[gate.mOut], out);
+            nets[gate.mOut] = out;
+        }
+    }
+
+    // Read outputs
+    aOutputs.resize(mOutputNets.size());
+    for (int i = 0; i < int(mOutputNets.size()); i++)
+    {
+        aOutputs[i] = nets[mOutputNets[i]];
+    }
+}
+
+template <class TRecorder>
+inline void CNetlist::SettleLevelWords(CEvalContext &aContext, const std::vector<int> &aGates,
+                                       TRecorder &aRecorder) const
+{
+    // As SettleLevel, for each of the 64 patterns. Outputs are recorded once, after settling.
+    LogicWord *nets = aContext.mWords.data();
+    const std::vector<int> &gates = aGates;
+    std::vector<LogicWord> &before = aContext.mLoopWords;
+    before.resize(gates.size());
+    for (int i = 0; i < int(gates.size()); i++) before[i] = nets[mGates[gates[i]].mOut];
+
+    bool changed = true;
+    for (int pass = 0; changed && pass <= int(gates.size()); pass++)
+    {
+        changed = false;
+        for (int g : gates)
+        {
+            const Gate &gate = mGates[g];
+            int in1 = (gate.mIn[1] >= 0) ? gate.mIn[1] : gate.mIn[0];
+            LogicWord out = ComputeGateWord(gate.mOp, nets[gate.mIn[0]], nets[in1]);
+            LogicWord &net = nets[gate.mOut];
+            if (out.mHigh == net.mHigh && out.mUndefined == net.mUndefined) continue;
+            net = out;
+            changed = true;
+        }
+    }
+    for (int i = 0; changed && i < int(gates.size()); i++)
+    {
+        const Gate &gate = mGates[gates[i]];
+        int in1 = (gate.mIn[1] >= 0) ? gate.mIn[1] : gate.mIn[0];
+        LogicWord out = ComputeGateWord(gate.mOp, nets[gate.mIn[0]], nets[in1]);
+        LogicWord &net = nets[gate.mOut];
+        uint64_t unsettled = (out.mHigh ^ net.mHigh) | (out.mUndefined ^ net.mUndefined);
+        if (unsettled == 0) continue;
+        net.mHigh &= ~unsettled;
+        net.mUndefined |= unsettled;
+        aContext.mUnsettled.push_back(gate.mOut);
+    }
+
+    for (int i = 0; i < int(gates.size()); i++)
+    {
+        aRecorder.Record(mGates[gates[i]].mOut, before[i], nets[mGates[gates[i]].mOut]);
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("popcnt")))
+#endif
+void CNetlist::EvaluateWordsPopcnt(CEvalContext &aContext, const std::vector<LogicWord> &aInputs,
+                                   std::vector<LogicWord> &aOutputs, CToggleAnalyzer::Recorder aRecorder) const
+{
+    EvaluateWordsWith(aContext, aInputs, aOutputs, aRecorder);
+}
+
+void CNetlist::EvaluateWords(CEvalContext &aContext, const std::vector<LogicWord> &aInputs,
+                             std::vector<LogicWord> &aOutputs) const
+{
+    NoRecorder none;
+    EvaluateWordsWith(aContext, aInputs, aOutputs, none);
+}
+
+void CNetlist::EvaluateWords(CEvalContext &aContext, const std::vector<LogicWord> &aInputs,
+                             std::vector<LogicWord> &aOutputs, CToggleAnalyzer &aActivity,
+                             int aPatterns) const
+{
+    if (aPatterns <= 0) return;
+    CToggleAnalyzer::Recorder recorder = aActivity.BeginWord(aPatterns);
+#if defined(__x86_64__) || defined(__i386__)
+    if (HasPopcnt())
+    {
+        EvaluateWordsPopcnt(aContext, aInputs, aOutputs, recorder);
+        return;
+    }
+#endif
+    EvaluateWordsWith(aContext, aInputs, aOutputs, recorder);
+}
+
+template <class TLanes>
+__attribute__((always_inline))
+inline void CNetlist::ComputeBlocksWith(CEvalContext &aContext) const
+{
+    LogicBlock *nets = aContext.mBlocks.data();
+    for (int l = 0; l < int(mLevels.size()); l++)
+    {
+        if (mLoopLevels[l])
+        {
+            SettleLevelBlocks(aContext, mLevels[l]);
+            continue;
+        }
+        for (int g : mLevels[l])
+        {
+            // Single input gates read their input twice, their tables ignore in1
+            const Gate &gate = mGates[g];
+            int in1 = (gate.mIn[1] >= 0) ? gate.mIn[1] : gate.mIn[0];
+            ComputeGateBlock<TLanes>(gate.mOp, nets[gate.mIn[0]], nets[in1], nets[gate.mOut]);
+        }
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("avx2")))
+void CNetlist::ComputeBlocksAvx2(CEvalContext &aContext) const
+{
+    ComputeBlocksWith<Avx2Lanes>(aContext);
+}
+
+__attribute__((target("avx512f")))
+void CNetlist::ComputeBlocksAvx512(CEvalContext &aContext) const
+{
+    ComputeBlocksWith<Avx512Lanes>(aContext);
+}
+#else
+void CNetlist::ComputeBlocksAvx2(CEvalContext &aContext) const
+{
+    ComputeBlocksWith<PortableLanes>(aContext);
+}
+
+void CNetlist::ComputeBlocksAvx512(CEvalContext &aContext) const
+{
+    ComputeBlocksWith<PortableLanes>(aContext);
+}
+#endif
+
+void CNetlist::SettleLevelBlocks(CEvalContext &aContext, const std::vector<int> &aGates) const
+{
+    // As SettleLevelWords, word by word. Each pattern settles on its own, so passing over all
+    // 512 together gives the same levels as passing over each 64.
+    LogicBlock *nets = aContext.mBlocks.data();
+    const std::vector<int> &gates = aGates;
+    bool changed = true;
+    for (int pass = 0; changed && pass <= int(gates.size()); pass++)
+    {
+        changed = false;
+        for (int g : gates)
+        {
+            const Gate &gate = mGates[g];
+            int in1 = (gate.mIn[1] >= 0) ? gate.mIn[1] : gate.mIn[0];
+            LogicBlock &net = nets[gate.mOut];
+            for (int w = 0; w < LogicBlock::Words; w++)
+            {
+                LogicWord out = ComputeGateWord(gate.mOp, BlockWord(nets[gate.mIn[0]], w), BlockWord(nets[in1], w));
+                if (out.mHigh == net.mHigh[w] && out.mUndefined == net.mUndefined[w]) continue;
+                net.mHigh[w] = out.mHigh;
+                net.mUndefined[w] = out.mUndefined;
+                changed = true;
+            }
+        }
+    }
+    for (int i = 0; changed && i < int(gates.size()); i++)
+    {
+        const Gate &gate = mGates[gates[i]];
+        int in1 = (gate.mIn[1] >= 0) ? gate.mIn[1] : gate.mIn[0];
+        LogicBlock &net = nets[gate.mOut];
+        bool unsettledNet = false;
+        for (int w = 0; w < LogicBlock::Words; w++)
+        {
+            LogicWord out = ComputeGateWord(gate.mOp, BlockWord(nets[gate.mIn[0]], w), BlockWord(nets[in1], w));
+            uint64_t unsettled = (out.mHigh ^ net.mHigh[w]) | (out.mUndefined ^ net.mUndefined[w]);
+            net.mHigh[w] &= ~unsettled;
+            net.mUndefined[w] |= unsettled;
+            if (unsettled != 0) unsettledNet = true;
+        }
+        if (unsettledNet) aContext.mUnsettled.push_back(gate.mOut);
+    }
+}
+
+void CNetlist::EvaluateBlocks(CEvalContext &aContext, const std::vector<LogicBlock> &aInputs,
+                              std::vector<LogicBlock> &aOutputs, eKernel aKernel) const
+{
+    if (aContext.mBlocks.size() != mNetNames.size()) aContext.ResizeBlocks(mNetNames.size());
+    aContext.mUnsettled.clear();
+    PrepareFlops(aContext);
+    LogicBlock *nets = aContext.mBlocks.data();
+    LogicBlock undefined;
+    for (int w = 0; w < LogicBlock::Words; w++)
+    {
+        undefined.mHigh[w] = 0;
+        undefined.mUndefined[w] = ~uint64_t(0);
+    }
+
+    // Drive inputs
+    for (int i = 0; i < int(mInputNets.size()); i++)
+    {
+        nets[mInputNets[i]] = (i < int(aInputs.size())) ? aInputs[i] : undefined;
+    }
+    for (int i = 0; i < int(mConstantNets.size()); i++)
+    {
+        LogicBlock &net = nets[mConstantNets[i]];
+        for (int w = 0; w < LogicBlock::Words; w++)
+        {
+            net.mHigh[w] = (mConstantLevels[i] == LOGIC_HIGH) ? ~uint64_t(0) : 0;
+            net.mUndefined[w] = (mConstantLevels[i] == LOGIC_UNDEFINED) ? ~uint64_t(0) : 0;
+        }
+    }
+    for (int f = 0; f < int(mFlops.size()); f++)
+    {
+        nets[mFlops[f].mQ] = aContext.mFlopBlocks[f];
+    }
+    for (int net : mUndrivenNets)
+    {
+        nets[net] = undefined;
+    }
+
+    // Compute every gate with the fastest kernel asked for that the CPU has
+    switch (std::min(aKernel, BestCpuKernel()))
+    {
+    case KERNEL_AVX512:
+        ComputeBlocksAvx512(aContext);
+        break;
+    case KERNEL_AVX2:
+        ComputeBlocksAvx2(aContext);
+        break;
+    default:
+        ComputeBlocksWith<PortableLanes>(aContext);
+        break;
+    }
+
+    // Read outputs
+    aOutputs.resize(mOutputNets.size());
+    for (int i = 0; i < int(mOutputNets.size()); i++)
+    {
+        aOutputs[i] = nets[mOutputNets[i]];
+    }
+}
+
+eKernel CNetlist::BestKernel()
+{
+    return BestCpuKernel();
+}
+
+const char* CNetlist::KernelName(eKernel aKernel)
+{
+    switch (aKernel)
+    {
+    case KERNEL_AVX512:
+        return "AVX-512";
+    case KERNEL_AVX2:
+        return "AVX2";
+    default:
+        return "portable";
+    }
+}
+
+void CNetlist::Reevaluate(CEvalContext &aContext, const std::vector<eLogicLevel> &aInputs,
+                          std::vector<eLogicLevel> &aOutputs) const
+{
+    // Without a previous evaluation, or with one from before a Reorder, there is nothing to update
+    if (aContext.mEditsSeen > mEdits.size() ||
+        std::find(mEdits.begin() + aContext.mEditsSeen, mEdits.end(), -1) != mEdits.end())
+    {
+        Evaluate(aContext, aInputs, aOutputs);
+        return;
+    }
+    if (aContext.mNets.size() != mNetNames.size()) aContext.Resize(mNetNames.size());
+    aContext.mQueued.resize(mGates.size(), 0);
+    aContext.mUnsettled.clear();
+    PrepareFlops(aContext);
+    eLogicLevel *nets = aContext.mNets.data();
+
+    // Gates to recompute, lowest level first
+    typedef std::pair<int, int> LevelGate;
+    std::priority_queue<LevelGate, std::vector<LevelGate>, std::greater<LevelGate>> queue;
+    auto queueGate = [&](int aGate) {
+        if (aContext.mQueued[aGate] || mGates[aGate].mOut < 0) return;
+        aContext.mQueued[aGate] = 1;
+        queue.push(LevelGate(mGateLevels[aGate], aGate));
+    };
+    auto queueFanout = [&](int aNet) {
+        for (int g : mFanouts[aNet]) queueGate(g);
+    };
+
+    // Changed inputs and flip-flop states
+    for (int i = 0; i < int(mInputNets.size()); i++)
+    {
+        eLogicLevel level = (i < int(aInputs.size())) ? aInputs[i] : LOGIC_UNDEFINED;
+        if (nets[mInputNets[i]] == level) continue;
+        nets[mInputNets[i]] = level;
+        queueFanout(mInputNets[i]);
+    }
+    for (int f = 0; f < int(mFlops.size()); f++)
+    {
+        if (nets[mFlops[f].mQ] == aContext.mFlops[f]) continue;
+        nets[mFlops[f].mQ] = aContext.mFlops[f];
+        queueFanout(mFlops[f].mQ);
+    }
+
+    // Nets edited since the context was last evaluated: recompute their driver, or reset them
+    // if they were left undriven
+    for (size_t e = aContext.mEditsSeen; e < mEdits.size(); e++)
+    {
+        int net = mEdits[e];
+        if (mDrivers[net] >= 0)
+        {
+            queueGate(mDrivers[net]);
+        }
+        else if (!IsSourceNet(net) && nets[net] != LOGIC_UNDEFINED)
+        {
+            nets[net] = LOGIC_UNDEFINED;
+            queueFanout(net);
+        }
+    }
+    aContext.mEditsSeen = mEdits.size();
+
+    // Propagate only while outputs change. Each gate is computed at most once, after every gate
+    // driving it, except loops, which are settled whole.
+    while (!queue.empty())
+    {
+        int g = queue.top().second;
+        int level = queue.top().first;
+        queue.pop();
+        aContext.mQueued[g] = 0;
+        const Gate &gate = mGates[g];
+        if (gate.mOut < 0) continue;
+        if (mLoopLevels[level])
+        {
+            // Settle the whole level and pass on the outputs that changed
+            for (; !queue.empty() && queue.top().first == level; queue.pop())
+            {
+                aContext.mQueued[queue.top().second] = 0;
+            }
+            std::vector<eLogicLevel> before;
+            for (int member : mLevels[level]) before.push_back(nets[mGates[member].mOut]);
+            SettleLevel(aContext, mLevels[level]);
+            for (int i = 0; i < int(before.size()); i++)
+            {
+                int net = mGates[mLevels[level][i]].mOut;
+                if (nets[net] == before[i]) continue;
+                for (int next : mFanouts[net])
+                {
+                    if (mGateLevels[next] != level) queueGate(next);
+                }
+            }
+            continue;
+        }
+        eLogicLevel in1 = nets[(gate.mIn[1] >= 0) ? gate.mIn[1] : gate.mIn[0]];
+        eLogicLevel out = ComputeGate(gate.mOp, nets[gate.mIn[0]], in1);
+        if (out == nets[gate.mOut]) continue;
+        nets[gate.mOut] = out;
+        queueFanout(gate.mOut);
+    }
+
+    // Read outputs
+    aOutputs.resize(mOutputNets.size());
+    for (int i = 0; i < int(mOutputNets.size()); i++)
+    {
+        aOutputs[i] = nets[mOutputNets[i]];
+    }
+}
+
+void CNetlist::Cycle(CEvalContext &aContext, const std::vector<eLogicLevel> &aInputs,
+                     std::vector<eLogicLevel> &aOutputs) const
+{
+    Evaluate(aContext, aInputs, aOutputs);
+
+    // Clock edge: every flip-flop samples the levels settled before it
+    const eLogicLevel *nets = aContext.mNets.data();
+    for (int f = 0; f < int(mFlops.size()); f++)
+    {
+        const Flop &flop = mFlops[f];
+        eLogicLevel enable = (flop.mEnable >= 0) ? nets[flop.mEnable] : LOGIC_HIGH;
+        eLogicLevel reset = (flop.mReset >= 0) ? nets[flop.mReset] : LOGIC_LOW;
+        aContext.mFlops[f] = ComputeFlop(aContext.mFlops[f], nets[flop.mD], enable, reset);
+    }
+}
+
+void CNetlist::CycleWords(CEvalContext &aContext, const std::vector<LogicWord> &aInputs,
+                          std::vector<LogicWord> &aOutputs) const
+{
+    EvaluateWords(aContext, aInputs, aOutputs);
+
+    // Clock edge, as Cycle
+    const LogicWord *nets = aContext.mWords.data();
+    LogicWord high;
+    high.mHigh = ~uint64_t(0);
+    high.mUndefined = 0;
+    LogicWord low;
+    low.mHigh = 0;
+    low.mUndefined = 0;
+    for (int f = 0; f < int(mFlops.size()); f++)
+    {
+        const Flop &flop = mFlops[f];
+        const LogicWord &enable = (flop.mEnable >= 0) ? nets[flop.mEnable] : high;
+        const LogicWord &reset = (flop.mReset >= 0) ? nets[flop.mReset] : low;
+        aContext.mFlopWords[f] = ComputeFlopWord(aContext.mFlopWords[f], nets[flop.mD], enable, reset);
+    }
+}
+
+void CNetlist::CycleBlocks(CEvalContext &aContext, const std::vector<LogicBlock> &aInputs,
+                           std::vector<LogicBlock> &aOutputs, eKernel aKernel) const
+{
+    EvaluateBlocks(aContext, aInputs, aOutputs, aKernel);
+
+    // Clock edge, as Cycle, word by word
+    const LogicBlock *nets = aContext.mBlocks.data();
+    LogicWord high;
+    high.mHigh = ~uint64_t(0);
+    high.mUndefined = 0;
+    LogicWord low;
+    low.mHigh = 0;
+    low.mUndefined = 0;
+    for (int f = 0; f < int(mFlops.size()); f++)
+    {
+        const Flop &flop = mFlops[f];
+        LogicBlock &state = aContext.mFlopBlocks[f];
+        for (int w = 0; w < LogicBlock::Words; w++)
+        {
+            LogicWord enable = (flop.mEnable >= 0) ? BlockWord(nets[flop.mEnable], w) : high;
+            LogicWord reset = (flop.mReset >= 0) ? BlockWord(nets[flop.mReset], w) : low;
+            LogicWord next = ComputeFlopWord(BlockWord(state, w), BlockWord(nets[flop.mD], w), enable, reset);
+            state.mHigh[w] = next.mHigh;
+            state.mUndefined[w] = next.mUndefined;
+        }
+    }
+}
+
+void CNetlist::PrepareFlops(CEvalContext &aContext) const
+{
+    for (int f = aContext.mFlops.size(); f < int(mFlops.size()); f++)
+    {
+        aContext.mFlops.push_back(mFlops[f].mInitial);
+    }
+    for (int f = aContext.mFlopWords.size(); f < int(mFlops.size()); f++)
+    {
+        LogicWord word;
+        word.mHigh = (mFlops[f].mInitial == LOGIC_HIGH) ? ~uint64_t(0) : 0;
+        word.mUndefined = (mFlops[f].mInitial == LOGIC_UNDEFINED) ? ~uint64_t(0) : 0;
+        aContext.mFlopWords.push_back(word);
+    }
+    for (int f = aContext.mFlopBlocks.size(); f < int(mFlops.size()); f++)
+    {
+        LogicBlock block;
+        for (int w = 0; w < LogicBlock::Words; w++)
+        {
+            block.mHigh[w] = (mFlops[f].mInitial == LOGIC_HIGH) ? ~uint64_t(0) : 0;
+            block.mUndefined[w] = (mFlops[f].mInitial == LOGIC_UNDEFINED) ? ~uint64_t(0) : 0;
+        }
+        aContext.mFlopBlocks.push_back(block);
+    }
+}
+
+COutputCone CNetlist::MakeCone(const std::vector<int> &aOutputs) const
+{
+    COutputCone cone;
+    cone.mOutputs = aOutputs;
+    BuildCone(cone);
+    return cone;
+}
+
+void CNetlist::BuildCone(COutputCone &aCone) const
+{
+    // Walk back from the output nets through their drivers, marking each gate once
+    aCone.mGates = std::vector<uint64_t>((mGates.size() + 63) / 64, 0);
+    aCone.mGateSize = 0;
+    aCone.mUndrivenNets.clear();
+    std::vector<std::pair<int, int>> members;           // level and gate of each member
+    std::vector<int> nets;                              // nets whose drivers are still to visit
+    for (int o : aCone.mOutputs) nets.push_back(mOutputNets[o]);
+    std::vector<bool> visited(mNetNames.size(), false);
+    while (!nets.empty())
+    {
+        int net = nets.back();
+        nets.pop_back();
+        if (net < 0 || visited[net]) continue;
+        visited[net] = true;
+        int g = mDrivers[net];
+        if (g < 0)
+        {
+            if (!IsSourceNet(net)) aCone.mUndrivenNets.push_back(net);
+            continue;
+        }
+        aCone.mGates[g / 64] |= uint64_t(1) << (g % 64);
+        aCone.mGateSize++;
+        members.push_back(std::make_pair(mGateLevels[g], g));
+        nets.push_back(mGates[g].mIn[0]);
+        nets.push_back(mGates[g].mIn[1]);
+    }
+
+    aCone.mInputs.clear();
+    for (int i = 0; i < int(mInputNets.size()); i++)
+    {
+        if (visited[mInputNets[i]]) aCone.mInputs.push_back(i);
+    }
+    aCone.mFlops.clear();
+    for (int f = 0; f < int(mFlops.size()); f++)
+    {
+        if (visited[mFlops[f].mQ]) aCone.mFlops.push_back(f);
+    }
+
+    // Schedule in level order. Each loop level is settled once, over only its gates in the cone,
+    // so loops of the level outside the cone are neither computed nor reported unsettled.
+    std::sort(members.begin(), members.end());
+    aCone.mSchedule.clear();
+    aCone.mLoopGates.clear();
+    for (int i = 0; i < int(members.size()); i++)
+    {
+        int level = members[i].first;
+        if (!mLoopLevels[level]) aCone.mSchedule.push_back(members[i].second);
+        else if (i == 0 || members[i - 1].first != level)
+        {
+            aCone.mSchedule.push_back(-1 - int(aCone.mLoopGates.size()));
+            aCone.mLoopGates.push_back(std::vector<int>());
+            for (int g : mLevels[level])
+            {
+                if (aCone.ContainsGate(g)) aCone.mLoopGates.back().push_back(g);
+            }
+        }
+    }
+    aCone.mEditsSeen = mEdits.size();
+}
+
+void CNetlist::EvaluateCone(CEvalContext &aContext, COutputCone &aCone, const std::vector<eLogicLevel> &aInputs,
+                            std::vector<eLogicLevel> &aOutputs) const
+{
+    if (aCone.mEditsSeen != mEdits.size()) BuildCone(aCone);
+    if (aContext.mNets.size() != mNetNames.size()) aContext.Resize(mNetNames.size());
+    aContext.mEditsSeen = ~size_t(0);
+    aContext.mUnsettled.clear();
+    PrepareFlops(aContext);
+    eLogicLevel *nets = aContext.mNets.data();
+
+    // Drive the cone's inputs
+    for (int i : aCone.mInputs)
+    {
+        nets[mInputNets[i]] = (i < int(aInputs.size())) ? aInputs[i] : LOGIC_UNDEFINED;
+    }
+    for (int i = 0; i < int(mConstantNets.size()); i++)
+    {
+        nets[mConstantNets[i]] = mConstantLevels[i];
+    }
+    for (int f : aCone.mFlops)
+    {
+        nets[mFlops[f].mQ] = aContext.mFlops[f];
+    }
+    for (int net : aCone.mUndrivenNets)
+    {
+        nets[net] = LOGIC_UNDEFINED;
+    }
+
+    // Compute the cone's gates in level order
+    for (int g : aCone.mSchedule)
+    {
+        if (g < 0)
+        {
+            SettleLevel(aContext, aCone.mLoopGates[-1 - g]);
+            continue;
+        }
+        const Gate &gate = mGates[g];
+        eLogicLevel in1 = nets[(gate.mIn[1] >= 0) ? gate.mIn[1] : gate.mIn[0]];
+        nets[gate.mOut] = ComputeGate(gate.mOp, nets[gate.mIn[0]], in1);
+    }
+
+    // Read the cone's outputs
+    aOutputs.resize(aCone.mOutputs.size());
+    for (int i = 0; i < int(aCone.mOutputs.size()); i++)
+    {
+        aOutputs[i] = nets[mOutputNets[aCone.mOutputs[i]]];
+    }
+}
+
+void CNetlist::EvaluateConeWords(CEvalContext &aContext, COutputCone &aCone, const std::vector<LogicWord> &aInputs,
+                                 std::vector<LogicWord> &aOutputs) const
+{
+    if (aCone.mEditsSeen != mEdits.size()) BuildCone(aCone);
+    if (aContext.mWords.size() != mNetNames.size()) aContext.Resize(mNetNames.size());
+    aContext.mUnsettled.clear();
+    PrepareFlops(aContext);
+    LogicWord *nets = aContext.mWords.data();
+    LogicWord undefined;
+    undefined.mHigh = 0;
+    undefined.mUndefined = ~uint64_t(0);
+
+    // Drive the cone's inputs
+    for (int i : aCone.mInputs)
+    {
+        nets[mInputNets[i]] = (i < int(aInputs.size())) ? aInputs[i] : undefined;
+    }
+    for (int i = 0; i < int(mConstantNets.size()); i++)
+    {
+        nets[mConstantNets[i]].mHigh = (mConstantLevels[i] == LOGIC_HIGH) ? ~uint64_t(0) : 0;
+        nets[mConstantNets[i]].mUndefined = (mConstantLevels[i] == LOGIC_UNDEFINED) ? ~uint64_t(0) : 0;
+    }
+    for (int f : aCone.mFlops)
+    {
+        nets[mFlops[f].mQ] = aContext.mFlopWords[f];
+    }
+    for (int net : aCone.mUndrivenNets)
+    {
+        nets[net] = undefined;
+    }
+
+    // Compute the cone's gates in level order
+    NoRecorder none;
+    for (int g : aCone.mSchedule)
+    {
+        if (g < 0)
+        {
+            SettleLevelWords(aContext, aCone.mLoopGates[-1 - g], none);
+            continue;
+        }
+        const Gate &gate = mGates[g];
+        int in1 = (gate.mIn[1] >= 0) ? gate.mIn[1] : gate.mIn[0];
+        nets[gate.mOut] = ComputeGateWord(gate.mOp, nets[gate.mIn[0]], nets[in1]);
+    }
+
+    // Read the cone's outputs
+    aOutputs.resize(aCone.mOutputs.size());
+    for (int i = 0; i < int(aCone.mOutputs.size()); i++)
+    {
+        aOutputs[i] = nets[mOutputNets[aCone.mOutputs[i]]];
+    }
+}
+
+int CNetlist::SweepWords(uint64_t aFirstPattern, std::vector<LogicWord> &aInputs) const
+{
+    // Repeating masks for the six lowest assignment bits
+    static const uint64_t laneBits[6] = {
+        0xAAAAAAAAAAAAAAAAull, 0xCCCCCCCCCCCCCCCCull, 0xF0F0F0F0F0F0F0F0ull,
+        0xFF00FF00FF00FF00ull, 0xFFFF0000FFFF0000ull, 0xFFFFFFFF00000000ull
+    };
+
+    int width = mInputNets.size();
+    aInputs.resize(width);
+    for (int i = 0; i < width; i++)
+    {
+        int bit = width - 1 - i;
+        aInputs[i].mUndefined = 0;
+        if (bit < 6) aInputs[i].mHigh = laneBits[bit];
+        else if (bit < 64) aInputs[i].mHigh = ((aFirstPattern >> bit) & 1) ? ~uint64_t(0) : 0;
+        else aInputs[i].mHigh = 0;
+    }
+
+    // Count assignments left in the sweep
+    if (width >= 64) return 64;
+    uint64_t total = uint64_t(1) << width;
+    return (total - aFirstPattern < 64) ? int(total - aFirstPattern) : 64;
+}
+
+int CNetlist::SweepBlocks(uint64_t aFirstPattern, std::vector<LogicBlock> &aInputs) const
+{
+    std::vector<LogicWord> words;
+    int valid = 0;
+    aInputs.resize(mInputNets.size());
+    for (int w = 0; w < LogicBlock::Words; w++)
+    {
+        // Words past the end of the sweep repeat its last one
+        int count = SweepWords(aFirstPattern + 64 * w, words);
+        if (count <= 0) break;
+        for (int i = 0; i < int(words.size()); i++)
+        {
+            for (int rest = w; rest < LogicBlock::Words; rest++)
+            {
+                aInputs[i].mHigh[rest] = words[i].mHigh;
+                aInputs[i].mUndefined[rest] = words[i].mUndefined;
+            }
+        }
+        valid += count;
+        if (count < 64) break;
+    }
+    return valid;
+}
+
+int CNetlist::FanoutSize(int aNet) const
+{
+    return mFanouts[aNet].size();
+}
+
+int CNetlist::NetSize() const
+{
+    return mNetNames.size();
+}
+
+int CNetlist::GateSize() const
+{
+    return mGates.size();
+}
+
+int CNetlist::GateInputSize(int aGate) const
+{
+    if (mGates[aGate].mOut < 0) return 0;
+    return (mGates[aGate].mOp == GATE_NOT || mGates[aGate].mOp == GATE_BUF) ? 1 : 2;
+}
+
+int CNetlist::InputSize() const
+{
+    return mInputNets.size();
+}
+
+int CNetlist::InputNet(int aInput) const
+{
+    return mInputNets[aInput];
+}
+
+int CNetlist::OutputSize() const
+{
+    return mOutputNets.size();
+}
+
+int CNetlist::LevelSize() const
+{
+    return mLevels.size();
+}
+
+void CNetlist::ReportLoops() const
+{
+    // Name each loop by the nets it drives
+    for (const std::vector<int> &loop : mLoops)
+    {
+        std::cout << "Combinational loop through " << loop.size() << " gates:";
+        int listed = 0;
+        for (int g : loop)
+        {
+            const std::string &name = mNetNames[mGates[g].mOut];
+            if (name.empty()) continue;
+            if (listed++ == 8)
+            {
+                std::cout << " ...";
+                break;
+            }
+            std::cout << " " << name;
+        }
+        std::cout << std::endl;
+    }
+}
+
+int CNetlist::FlopSize() const
+{
+    return mFlops.size();
+}
+
+int CNetlist::FlopOutput(int aFlop) const
+{
+    return mFlops[aFlop].mQ;
+}
+
+int CNetlist::LoopSize() const
+{
+    return mLoops.size();
+}
+
+std::vector<int> CNetlist::LoopNets(int aLoop) const
+{
+    std::vector<int> nets;
+    for (int g : mLoops[aLoop]) nets.push_back(mGates[g].mOut);
+    return nets;
+}
+
+const std::string& CNetlist::NetName(int aNet) const
+{
+    return mNetNames[aNet];
+}
+
+int CNetlist::FindNet(const std::string &aName) const
+{
+    std::unordered_map<std::string, int>::const_iterator it = mNetIndex.find(aName);
+    return (it == mNetIndex.end()) ? -1 : it->second;
+}
+
+std::vector<std::pair<std::string, int>> CNetlist::NamedNets() const
+{
+    std::vector<std::pair<std::string, int>> names(mNetIndex.begin(), mNetIndex.end());
+    std::sort(names.begin(), names.end());
+    return names;
+}
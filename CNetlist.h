@@ -0,0 +1,592 @@
+#ifndef _CNETLIST_H
+#define _CNETLIST_H
+
+//--Includes-------------------------------------------------------------------
+#include "CLogic.h"
+#include "CEvalContext.h"
+#include "CToggleAnalyzer.h"
+#include "COutputCone.h"
+
+#include <vector>
+#include <unordered_map>
+#include <string>
+
+//--Consts and enums-----------------------------------------------------------
+enum eGateOp // enum defining the primitive operations of a flattened netlist
+{
+    GATE_AND,
+    GATE_OR,
+    GATE_XOR,
+    GATE_NOT,
+    GATE_BUF
+};
+
+enum eKernel // enum defining the gate evaluation kernels of CNetlist::EvaluateBlocks, by capability
+{
+    KERNEL_PORTABLE,    // 64 bit words
+    KERNEL_AVX2,        // 256 bit vectors
+    KERNEL_AVX512       // 512 bit vectors
+};
+
+//---CNetlist Declaration-------------------------------------------------------
+// CNetlist is a flattened, levelized copy of the structure of a CLogic element
+//
+// Nested circuits are expanded into primitive gates connected by numbered nets. The netlist holds
+// no signal levels: those live in a CEvalContext, so once built a netlist is never modified by
+// evaluation and any number of threads may evaluate it at once, each with its own context.
+class CNetlist
+{
+public:
+    /**
+     * Constructor for an empty netlist, filled with AddNet, AddGate, AddInput and AddOutput
+    */
+    CNetlist();
+
+    /**
+     * Constructor flattening a logic element and its nested circuits
+     *
+     * @param apLogic logic element to flatten
+    */
+    CNetlist(CLogic *apLogic);
+
+    /**
+     * Add a new net
+     *
+     * @param aName name of net, may be empty
+     * @return net number
+    */
+    int AddNet(std::string aName = "");
+
+    /**
+     * Add another name for a net. The first name given becomes its primary name.
+     *
+     * @param aNet net number
+     * @param aName name of net
+    */
+    void NameNet(int aNet, std::string aName);
+
+    /**
+     * Add a primitive gate
+     *
+     * @param aOp gate operation
+     * @param aInput0 net driving first input
+     * @param aInput1 net driving second input, ignored by GATE_NOT and GATE_BUF
+     * @param aOutput net driven by the gate
+     * @return gate number, or -1 if an input the operation needs is missing
+    */
+    int AddGate(eGateOp aOp, int aInput0, int aInput1, int aOutput);
+
+    /**
+     * Add a net as the next netlist input
+     *
+     * @param aNet net number
+    */
+    void AddInput(int aNet);
+
+    /**
+     * Tie a net to a constant level, driven like an input on every evaluation
+     *
+     * @param aNet net number
+     * @param aLevel level of the net
+    */
+    void AddConstant(int aNet, eLogicLevel aLevel);
+
+    /**
+     * Add a D flip-flop clocked by Cycle. Its output is a source for the combinational logic,
+     * driven with its state, so flip-flops cut any loop through them. At each clock edge a
+     * HIGH reset loads LOGIC_LOW, else a HIGH enable loads the D input, else the state holds.
+     * An undefined enable or reset gives LOGIC_UNDEFINED unless both choices agree.
+     *
+     * @param aD net sampled at the clock edge
+     * @param aEnable net enabling the load, -1 for always enabled
+     * @param aReset net resetting the state, -1 for none
+     * @param aQ net driven with the state
+     * @param aInitial state before the first clock edge
+     * @return flip-flop number
+    */
+    int AddFlop(int aD, int aEnable, int aReset, int aQ, eLogicLevel aInitial = LOGIC_LOW);
+
+    /**
+     * Reserve memory for a netlist about to be built
+     *
+     * @param aNets expected number of nets
+     * @param aGates expected number of gates
+    */
+    void Reserve(int aNets, int aGates);
+
+    /**
+     * Add a net as the next netlist output
+     *
+     * @param aNet net number
+    */
+    void AddOutput(int aNet);
+
+    /**
+     * Build the fanout lists and evaluation order. Must be called before the first evaluation.
+     * Combinational loops are found as strongly connected components. Each is placed whole in one 
+     * level, which evaluation iterates until it settles.
+     * Afterwards every Add call and edit updates them for the affected fanout cone only.
+     * Editing must not overlap evaluation in other threads.
+    */
+    void Finalize();
+
+    /**
+     * Renumber gates and nets for cache locality, dropping removed gates. Gates are numbered in 
+     * evaluation order, level by level, and within each level in the order a depth first search
+     * from the outputs reaches them, so gates of one cone stay together from level to level.
+     * Nets are numbered inputs first, then by the gate driving them. Inputs, outputs and names
+     * are kept; net and gate numbers, contexts and cones from before are invalidated.
+    */
+    void Reorder();
+
+    /**
+     * Change the operation of a gate, keeping its connections
+     *
+     * @param aGate gate number
+     * @param aOp new operation
+     * @param aInput1 net driving the second input, needed when a GATE_NOT or GATE_BUF becomes 
+     *                a two input gate
+     * @return whether the gate was changed, false for a removed gate or a missing second input
+    */
+    bool ReplaceGate(int aGate, eGateOp aOp, int aInput1 = -1);
+
+    /**
+     * Connect an input of a gate to another net
+     *
+     * @param aGate gate number
+     * @param aInput input number
+     * @param aNet net to drive the input, or -1 for the unused second input of a single input gate
+     * @return whether the input was connected, false for a removed gate, an input the gate 
+     *         needs left unconnected or a second input given to a single input gate
+    */
+    bool ReconnectInput(int aGate, int aInput, int aNet);
+
+    /**
+     * Connect the output of a gate to another net. The old net is left undriven and any other
+     * gate driving the new net is removed.
+     *
+     * @param aGate gate number
+     * @param aNet net for the gate to drive
+    */
+    void ReconnectOutput(int aGate, int aNet);
+
+    /**
+     * Remove a gate, leaving its output net undriven. Gate numbers are not reused.
+     *
+     * @param aGate gate number
+    */
+    void RemoveGate(int aGate);
+
+    /**
+     * return gate driving a net
+     *
+     * @param aNet net number
+     * @return gate number, or -1 if no gate drives the net
+    */
+    int NetDriver(int aNet) const;
+
+    /**
+     * Evaluate the netlist for one input assignment. Safe to call concurrently from several
+     * threads as long as each uses its own context.
+     *
+     * @param aContext signal levels of the evaluating thread
+     * @param aInputs level of each input
+     * @param aOutputs filled with the level of each output
+    */
+    void Evaluate(CEvalContext &aContext, const std::vector<eLogicLevel> &aInputs,
+                  std::vector<eLogicLevel> &aOutputs) const;
+
+    /**
+     * Evaluate the netlist for a sequence of input assignments
+     *
+     * @param aContext signal levels of the evaluating thread
+     * @param aInputs level of each input, for each assignment
+     * @param aOutputs filled with the level of each output, for each assignment
+    */
+    void EvaluateBatch(CEvalContext &aContext, const std::vector<std::vector<eLogicLevel>> &aInputs,
+                       std::vector<std::vector<eLogicLevel>> &aOutputs) const;
+
+    /**
+     * Update a context evaluated before for a new input assignment and any edits made since. Only
+     * gates in the fanout cones of changed inputs and edited nets are recomputed, stopping 
+     * wherever a gate's output is unchanged. A context from before a Reorder is evaluated in full.
+     *
+     * @param aContext signal levels of the evaluating thread
+     * @param aInputs level of each input
+     * @param aOutputs filled with the level of each output
+    */
+    void Reevaluate(CEvalContext &aContext, const std::vector<eLogicLevel> &aInputs,
+                    std::vector<eLogicLevel> &aOutputs) const;
+
+    /**
+     * Evaluate the netlist for 64 input assignments at once, one per bit of each word
+     *
+     * @param aContext signal levels of the evaluating thread
+     * @param aInputs levels of each input
+     * @param aOutputs filled with the levels of each output
+    */
+    void EvaluateWords(CEvalContext &aContext, const std::vector<LogicWord> &aInputs,
+                       std::vector<LogicWord> &aOutputs) const;
+
+    /**
+     * Evaluate the netlist for up to 64 input assignments at once and record the switching 
+     * activity of every net. The activity carries on from the previous call made with the same 
+     * context and analyzer, so consecutive calls form one pattern stream.
+     *
+     * @param aContext signal levels of the evaluating thread
+     * @param aInputs levels of each input
+     * @param aOutputs filled with the levels of each output
+     * @param aActivity analyzer recording the activity
+     * @param aPatterns number of valid assignments, counted from bit 0
+    */
+    void EvaluateWords(CEvalContext &aContext, const std::vector<LogicWord> &aInputs,
+                       std::vector<LogicWord> &aOutputs, CToggleAnalyzer &aActivity,
+                       int aPatterns = 64) const;
+
+    /**
+     * Evaluate the netlist for 512 input assignments at once, one per bit of each block. Every
+     * kernel gives bit-for-bit the same levels as EvaluateWords on the same 64 assignments.
+     *
+     * @param aContext signal levels of the evaluating thread
+     * @param aInputs levels of each input
+     * @param aOutputs filled with the levels of each output
+     * @param aKernel kernel computing the gates, BestKernel() if the CPU lacks it
+    */
+    void EvaluateBlocks(CEvalContext &aContext, const std::vector<LogicBlock> &aInputs,
+                        std::vector<LogicBlock> &aOutputs, eKernel aKernel = BestKernel()) const;
+
+    /**
+     * return fastest kernel the CPU supports, chosen once at startup
+    */
+    static eKernel BestKernel();
+
+    /**
+     * return name of a kernel
+    */
+    static const char* KernelName(eKernel aKernel);
+
+    /**
+     * Simulate one clock cycle: evaluate the combinational logic with the inputs and the current
+     * flip-flop states, read the outputs, then load every flip-flop at once at the clock edge. 
+     * Flip-flop output nets in the context keep the state from before the edge.
+     *
+     * @param aContext signal levels and flip-flop states of the evaluating thread
+     * @param aInputs level of each input during the cycle
+     * @param aOutputs filled with the level of each output before the clock edge
+    */
+    void Cycle(CEvalContext &aContext, const std::vector<eLogicLevel> &aInputs,
+               std::vector<eLogicLevel> &aOutputs) const;
+
+    /**
+     * Cycle for 64 independent simulations at once, one per bit of each word
+     *
+     * @param aContext signal levels and flip-flop states of the evaluating thread
+     * @param aInputs levels of each input during the cycle
+     * @param aOutputs filled with the levels of each output before the clock edge
+    */
+    void CycleWords(CEvalContext &aContext, const std::vector<LogicWord> &aInputs,
+                    std::vector<LogicWord> &aOutputs) const;
+
+    /**
+     * Cycle for 512 independent simulations at once, one per bit of each block
+     *
+     * @param aContext signal levels and flip-flop states of the evaluating thread
+     * @param aInputs levels of each input during the cycle
+     * @param aOutputs filled with the levels of each output before the clock edge
+     * @param aKernel kernel computing the gates, BestKernel() if the CPU lacks it
+    */
+    void CycleBlocks(CEvalContext &aContext, const std::vector<LogicBlock> &aInputs,
+                     std::vector<LogicBlock> &aOutputs, eKernel aKernel = BestKernel()) const;
+
+    /**
+     * Precompute the transitive fanin cone of some outputs, for EvaluateCone
+     *
+     * @param aOutputs output numbers
+     * @return cone of the outputs
+    */
+    COutputCone MakeCone(const std::vector<int> &aOutputs) const;
+
+    /**
+     * Evaluate only the gates in the fanin cone of some outputs. Nets outside the cone keep their
+     * old levels, and only loop nets of the cone are listed as unsettled. The context is then
+     * treated as never evaluated by Reevaluate.
+     *
+     * @param aContext signal levels of the evaluating thread
+     * @param aCone cone made by MakeCone, rebuilt if the netlist was edited since
+     * @param aInputs level of each input
+     * @param aOutputs filled with the level of each output of the cone, in its order
+    */
+    void EvaluateCone(CEvalContext &aContext, COutputCone &aCone, const std::vector<eLogicLevel> &aInputs,
+                      std::vector<eLogicLevel> &aOutputs) const;
+
+    /**
+     * EvaluateCone for 64 input assignments at once, one per bit of each word
+     *
+     * @param aContext signal levels of the evaluating thread
+     * @param aCone cone made by MakeCone, rebuilt if the netlist was edited since
+     * @param aInputs levels of each input
+     * @param aOutputs filled with the levels of each output of the cone, in its order
+    */
+    void EvaluateConeWords(CEvalContext &aContext, COutputCone &aCone, const std::vector<LogicWord> &aInputs,
+                           std::vector<LogicWord> &aOutputs) const;
+
+    /**
+     * Fill the input words for 64 consecutive assignments of an exhaustive sweep. Assignment p
+     * drives input i with bit (InputSize() - 1 - i) of p, matching TestDriver::TestCircuit. 
+     * Inputs beyond the 64 bits of p are driven LOGIC_LOW.
+     *
+     * @param aFirstPattern first assignment, a multiple of 64
+     * @param aInputs filled with the levels of each input
+     * @return number of valid assignments in the words
+    */
+    int SweepWords(uint64_t aFirstPattern, std::vector<LogicWord> &aInputs) const;
+
+    /**
+     * SweepWords for 512 consecutive assignments, filling blocks
+     *
+     * @param aFirstPattern first assignment, a multiple of 64
+     * @param aInputs filled with the levels of each input
+     * @return number of valid assignments in the blocks
+    */
+    int SweepBlocks(uint64_t aFirstPattern, std::vector<LogicBlock> &aInputs) const;
+
+    /**
+     * return number of gate inputs a net drives
+     *
+     * @param aNet net number
+    */
+    int FanoutSize(int aNet) const;
+
+    /**
+     * return number of nets
+    */
+    int NetSize() const;
+
+    /**
+     * return number of gates
+    */
+    int GateSize() const;
+
+    /**
+     * return number of inputs of a gate, 0 once removed
+     *
+     * @param aGate gate number
+    */
+    int GateInputSize(int aGate) const;
+
+    /**
+     * return number of inputs
+    */
+    int InputSize() const;
+
+    /**
+     * return net driven by an input
+     *
+     * @param aInput input number
+    */
+    int InputNet(int aInput) const;
+
+    /**
+     * return number of outputs
+    */
+    int OutputSize() const;
+
+    /**
+     * return number of levels in the evaluation order
+    */
+    int LevelSize() const;
+
+    /**
+     * return number of flip-flops
+    */
+    int FlopSize() const;
+
+    /**
+     * return net driven by a flip-flop
+     *
+     * @param aFlop flip-flop number
+    */
+    int FlopOutput(int aFlop) const;
+
+    /**
+     * return number of combinational loops
+    */
+    int LoopSize() const;
+
+    /**
+     * return nets driven by the gates of a combinational loop
+     *
+     * @param aLoop loop number
+    */
+    std::vector<int> LoopNets(int aLoop) const;
+
+    /**
+     * Print each combinational loop with the names of up to 8 nets it drives
+    */
+    void ReportLoops() const;
+
+    /**
+     * return primary name of a net
+     *
+     * @param aNet net number
+    */
+    const std::string& NetName(int aNet) const;
+
+    /**
+     * return net with a given name
+     *
+     * @param aName any name of the net
+     * @return net number, or -1 if no net has that name
+    */
+    int FindNet(const std::string &aName) const;
+
+    /**
+     * return every name of every net, sorted by name
+     *
+     * @return pairs of name and net number
+    */
+    std::vector<std::pair<std::string, int>> NamedNets() const;
+
+private:
+    /**
+     * Drive the input words, compute every gate in level order and read the output words, 
+     * passing each net's previous and new word to a recorder
+     *
+     * @param aContext signal levels of the evaluating thread
+     * @param aInputs levels of each input
+     * @param aOutputs filled with the levels of each output
+     * @param aRecorder object with a Record(net, previous, current) method
+    */
+    template <class TRecorder>
+    void EvaluateWordsWith(CEvalContext &aContext, const std::vector<LogicWord> &aInputs,
+                           std::vector<LogicWord> &aOutputs, TRecorder &aRecorder) const;
+
+    /**
+     * Compute the gates of a level holding a combinational loop until no output changes. Nets
+     * still changing after one pass per gate are set to LOGIC_UNDEFINED and listed in the
+     * context as unsettled.
+     *
+     * @param aContext signal levels of the evaluating thread
+     * @param aGates gates of the level, or those of the level in an output cone
+    */
+    void SettleLevel(CEvalContext &aContext, const std::vector<int> &aGates) const;
+
+    /**
+     * SettleLevel for 64 input assignments at once, recording each output once it settles
+    */
+    template <class TRecorder>
+    void SettleLevelWords(CEvalContext &aContext, const std::vector<int> &aGates, TRecorder &aRecorder) const;
+
+    /**
+     * EvaluateWordsWith recording into a CToggleAnalyzer, compiled for the popcnt instruction
+    */
+    void EvaluateWordsPopcnt(CEvalContext &aContext, const std::vector<LogicWord> &aInputs,
+                             std::vector<LogicWord> &aOutputs, CToggleAnalyzer::Recorder aRecorder) const;
+
+    /**
+     * Compute every gate for 512 input assignments, in level order, with the nets already driven
+     *
+     * @param aContext signal levels of the evaluating thread
+    */
+    template <class TLanes>
+    void ComputeBlocksWith(CEvalContext &aContext) const;
+
+    /**
+     * ComputeBlocksWith for 256 bit vectors, compiled for AVX2
+    */
+    void ComputeBlocksAvx2(CEvalContext &aContext) const;
+
+    /**
+     * ComputeBlocksWith for 512 bit vectors, compiled for AVX-512
+    */
+    void ComputeBlocksAvx512(CEvalContext &aContext) const;
+
+    /**
+     * SettleLevel for 512 input assignments at once
+    */
+    void SettleLevelBlocks(CEvalContext &aContext, const std::vector<int> &aGates) const;
+
+    /**
+     * Size the flip-flop states of a context, each starting at its initial level
+    */
+    void PrepareFlops(CEvalContext &aContext) const;
+
+    /**
+     * Fill a cone's gates, schedule and undriven nets from its outputs
+    */
+    void BuildCone(COutputCone &aCone) const;
+
+    /**
+     * Add a gate to the end of a level
+    */
+    void PlaceGate(int aGate, int aLevel);
+
+    /**
+     * Remove a gate from its level
+    */
+    void UnplaceGate(int aGate);
+
+    /**
+     * return level of a gate from the levels of the gates driving it
+    */
+    int ComputeLevel(int aGate) const;
+
+    /**
+     * Recompute the levels of gates and of their fanout cones, as far as levels change
+    */
+    void UpdateLevels(const std::vector<int> &aGates);
+
+    /**
+     * Set the gate driving a net, -1 for none
+    */
+    void SetDriver(int aNet, int aGate);
+
+    /**
+     * Remove a gate from the fanout of a net
+    */
+    void EraseFanout(int aNet, int aGate);
+
+    /**
+     * return whether a net is an input or constant, which are never undriven
+    */
+    bool IsSourceNet(int aNet) const;
+
+    struct Gate
+    {
+        eGateOp mOp;        // operation
+        int mIn[2];         // input nets, -1 where unused
+        int mOut;           // output net, -1 once removed
+    };
+
+    struct Flop
+    {
+        int mD;                 // net sampled at the clock edge
+        int mEnable;            // enable net, -1 if always enabled
+        int mReset;             // reset net, -1 if none
+        int mQ;                 // net driven with the state
+        eLogicLevel mInitial;   // state before the first clock edge
+    };
+
+    std::vector<Gate> mGates;                           // primitive gates
+    std::vector<Flop> mFlops;                           // D flip-flops
+    std::vector<std::string> mNetNames;                 // primary name of each net
+    std::unordered_map<std::string, int> mNetIndex;     // net of every name
+    std::vector<int> mInputNets;                        // net of each input
+    std::vector<int> mOutputNets;                       // net of each output
+    std::vector<int> mConstantNets;                     // net of each constant
+    std::vector<eLogicLevel> mConstantLevels;           // level of each constant
+
+    std::vector<int> mDrivers;                          // gate driving each net, -1 if none
+    std::vector<std::vector<int>> mFanouts;             // gates reading each net
+    std::vector<int> mUndrivenNets;                     // nets driven by neither a gate nor an input
+    std::vector<std::vector<int>> mLevels;              // gates of each level, in evaluation order
+    std::vector<int> mGateLevels;                       // level of each gate
+    std::vector<int> mLevelSlots;                       // index of each gate in its level, -1 if unplaced
+    std::vector<char> mLoopLevels;                      // 1 for each level holding a loop
+    std::vector<std::vector<int>> mLoops;               // gates of each combinational loop
+    std::vector<int> mGateLoops;                        // loop of each gate, -1 if none
+    std::vector<int> mEdits;                            // nets changed by each edit, -1 for a Reorder
+    bool mFinalized;                                    // true once Finalize has run
+};
+
+#endif
@@ -0,0 +1,601 @@
+// See CNetlistReader.h
+//
+//--Includes-------------------------------------------------------------------
+#include "CNetlistReader.h"
+
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+
+//---Parsing helpers------------------------------------------------------------
+// Skip spaces and tabs, stopping at the end of the line
+static inline void SkipSpace(const char *&apText)
+{
+    while (*apText == ' ' || *apText == '\t' || *apText == '\r') apText++;
+}
+
+// Skip to the start of the next line
+static inline void SkipLine(const char *&apText, int &aLine)
+{
+    while (*apText != '\0' && *apText != '\n') apText++;
+    if (*apText == '\n')
+    {
+        apText++;
+        aLine++;
+    }
+}
+
+// Read a decimal number, returning false if there is none
+static inline bool ReadNumber(const char *&apText, uint64_t &aNumber)
+{
+    SkipSpace(apText);
+    if (*apText < '0' || *apText > '9') return false;
+    aNumber = 0;
+    while (*apText >= '0' && *apText <= '9') aNumber = aNumber * 10 + (*apText++ - '0');
+    return true;
+}
+
+// Read an AIGER binary delta: 7 bits per byte, low bits first, high bit set on all but the last
+static inline bool ReadDelta(const char *&apText, const char *apEnd, uint64_t &aDelta)
+{
+    aDelta = 0;
+    for (int shift = 0; apText < apEnd && shift < 64; shift += 7)
+    {
+        unsigned char byte = *apText++;
+        aDelta |= uint64_t(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+// Read a word ending at white space or any of aStops
+static inline std::string ReadWord(const char *&apText, const char *aStops = "")
+{
+    SkipSpace(apText);
+    const char *start = apText;
+    while (*apText != '\0' && !std::isspace((unsigned char)*apText) && std::strchr(aStops, *apText) == NULL)
+    {
+        apText++;
+    }
+    return std::string(start, apText - start);
+}
+
+//---CNetlistReader Implementation----------------------------------------------
+CNetlistReader::CNetlistReader(CNetlist &aNetlist) : mNetlist(aNetlist)
+{
+    mpCursor = NULL;
+    mLine = 0;
+    mConstants[0] = -1;
+    mConstants[1] = -1;
+}
+
+bool CNetlistReader::Read(const std::string &aPath)
+{
+    // Choose the format by extension
+    size_t dot = aPath.rfind('.');
+    std::string extension = (dot == std::string::npos) ? "" : aPath.substr(dot + 1);
+    for (char &c : extension) c = std::tolower((unsigned char)c);
+    if (extension == "aig" || extension == "aag") return ReadAiger(aPath);
+    if (extension == "blif") return ReadBlif(aPath);
+    if (extension == "bench") return ReadBench(aPath);
+    mError = aPath + ": unknown netlist format, expected .aig, .aag, .blif or .bench";
+    return false;
+}
+
+bool CNetlistReader::ReadAiger(const std::string &aPath)
+{
+    if (!Load(aPath)) return false;
+    const char *p = mpCursor;
+    const char *end = mText.data() + mText.size() - 1;
+
+    // Header: format and the maximum variable, input, latch, output and AND counts, then
+    // optionally AIGER 1.9 bad state, invariant constraint, justice and fairness counts
+    std::string format = ReadWord(p);
+    bool binary = (format == "aig");
+    if (!binary && format != "aag") return Fail("not an AIGER file");
+    uint64_t header[9] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+    for (int i = 0; i < 5; i++)
+    {
+        if (!ReadNumber(p, header[i])) return Fail("incomplete header");
+    }
+    for (int i = 5; i < 9 && ReadNumber(p, header[i]); i++) {}
+    SkipLine(p, mLine);
+    uint64_t maxVar = header[0], inputs = header[1], latches = header[2], outputs = header[3];
+    uint64_t ands = header[4];
+    if (binary && maxVar != inputs + latches + ands) return Fail("M must equal I + L + A in binary AIGER");
+
+    // One net per variable, allocated up front since AIGER may refer to variables before
+    // defining them. Complements are added as NOT gates on first use.
+    mNetlist.Reserve(2 * maxVar + 2, maxVar + ands + 2);
+    std::vector<int> nets(maxVar + 1);
+    nets[0] = Constant(false);
+    for (uint64_t v = 1; v <= maxVar; v++) nets[v] = mNetlist.AddNet();
+    auto literal = [&](uint64_t aLiteral) {
+        if (aLiteral >> 1 == 0) return Constant(aLiteral & 1);
+        int net = nets[aLiteral >> 1];
+        return (aLiteral & 1) ? Invert(net) : net;
+    };
+
+    // Inputs
+    std::vector<int> inputNets;
+    for (uint64_t i = 0; i < inputs; i++)
+    {
+        uint64_t lit = 2 * (i + 1);
+        if (!binary)
+        {
+            if (!ReadNumber(p, lit) || (lit & 1) || lit / 2 > maxVar) return Fail("bad input literal");
+            SkipLine(p, mLine);
+        }
+        if (!Define(nets[lit / 2], "variable " + std::to_string(lit / 2))) return false;
+        inputNets.push_back(nets[lit / 2]);
+        mNetlist.AddInput(nets[lit / 2]);
+    }
+
+    // Latches, added once the outputs are known. The next state literal may not be defined yet.
+    // The optional reset value is 0, 1, or the latch's own literal for an unknown initial state.
+    std::vector<std::pair<int, uint64_t>> latchNext;
+    std::vector<eLogicLevel> latchInitial;
+    for (uint64_t i = 0; i < latches; i++)
+    {
+        uint64_t lit = 2 * (inputs + i + 1);
+        uint64_t next, init = 0;
+        if (!binary && (!ReadNumber(p, lit) || (lit & 1) || lit / 2 > maxVar)) return Fail("bad latch literal");
+        if (!ReadNumber(p, next) || next / 2 > maxVar) return Fail("bad latch next state literal");
+        if (ReadNumber(p, init) && init > 1 && init != lit) return Fail("bad latch reset value");
+        SkipLine(p, mLine);
+        if (!Define(nets[lit / 2], "variable " + std::to_string(lit / 2))) return false;
+        latchNext.push_back(std::make_pair(nets[lit / 2], next));
+        latchInitial.push_back((init == 0) ? LOGIC_LOW : (init == 1) ? LOGIC_HIGH : LOGIC_UNDEFINED);
+    }
+
+    // Outputs, then bad state properties, which are outputs too
+    std::vector<uint64_t> outputLiterals;
+    for (uint64_t i = 0; i < outputs + header[5]; i++)
+    {
+        uint64_t lit;
+        if (!ReadNumber(p, lit) || lit / 2 > maxVar) return Fail("bad output literal");
+        SkipLine(p, mLine);
+        outputLiterals.push_back(lit);
+    }
+
+    // Constraints, justice and fairness properties are not simulated
+    for (uint64_t i = 0; i < header[6]; i++) SkipLine(p, mLine);
+    uint64_t justiceLines = 0;
+    for (uint64_t i = 0; i < header[7]; i++)
+    {
+        uint64_t size;
+        if (!ReadNumber(p, size)) return Fail("bad justice property");
+        justiceLines += size;
+        SkipLine(p, mLine);
+    }
+    for (uint64_t i = 0; i < justiceLines + header[8]; i++) SkipLine(p, mLine);
+
+    // AND gates
+    for (uint64_t i = 0; i < ands; i++)
+    {
+        uint64_t lhs, rhs0, rhs1;
+        if (binary)
+        {
+            // Each gate is two deltas: lhs - rhs0 and rhs0 - rhs1, with lhs implicit
+            uint64_t delta0, delta1;
+            lhs = 2 * (inputs + latches + i + 1);
+            if (!ReadDelta(p, end, delta0) || !ReadDelta(p, end, delta1) || delta0 > lhs ||
+                delta1 > lhs - delta0)
+            {
+                return Fail("bad delta for AND gate " + std::to_string(i));
+            }
+            rhs0 = lhs - delta0;
+            rhs1 = rhs0 - delta1;
+        }
+        else
+        {
+            if (!ReadNumber(p, lhs) || !ReadNumber(p, rhs0) || !ReadNumber(p, rhs1) || (lhs & 1) ||
+                lhs / 2 > maxVar || rhs0 / 2 > maxVar || rhs1 / 2 > maxVar)
+            {
+                return Fail("bad AND gate");
+            }
+            SkipLine(p, mLine);
+        }
+        // Binary gate outputs are implicit and distinct, so only ASCII ones can be defined twice
+        if (!binary && !Define(nets[lhs / 2], "variable " + std::to_string(lhs / 2))) return false;
+        mNetlist.AddGate(GATE_AND, literal(rhs0), literal(rhs1), nets[lhs / 2]);
+    }
+
+    // Symbol table, up to the comment section
+    std::vector<std::string> inputNames(inputs), latchNames(latches), outputNames(outputLiterals.size());
+    while (p < end && *p != 'c')
+    {
+        char kind = *p++;
+        uint64_t index;
+        if (!ReadNumber(p, index)) break;
+        SkipSpace(p);
+        const char *start = p;
+        while (p < end && *p != '\n') p++;
+        std::string name(start, p - start);
+        if (kind == 'i' && index < inputs) inputNames[index] = name;
+        else if (kind == 'l' && index < latches) latchNames[index] = name;
+        else if (kind == 'o' && index < outputs) outputNames[index] = name;
+        else if (kind == 'b' && index < header[5]) outputNames[outputs + index] = name;
+        SkipLine(p, mLine);
+    }
+
+    // Name inputs, latches and outputs, by symbol where given
+    for (uint64_t i = 0; i < inputs; i++)
+    {
+        mNetlist.NameNet(inputNets[i], inputNames[i].empty() ? "i" + std::to_string(i) : inputNames[i]);
+    }
+    for (uint64_t i = 0; i < latches; i++)
+    {
+        std::string name = latchNames[i].empty() ? "l" + std::to_string(i) : latchNames[i];
+        mNetlist.NameNet(latchNext[i].first, name);
+        mLatches.push_back(std::make_pair(latchNext[i].first, literal(latchNext[i].second)));
+        mLatchInitial.push_back(latchInitial[i]);
+    }
+    for (uint64_t i = 0; i < outputLiterals.size(); i++)
+    {
+        int net = literal(outputLiterals[i]);
+        std::string name = outputNames[i];
+        if (name.empty()) name = (i < outputs) ? "o" + std::to_string(i) : "b" + std::to_string(i - outputs);
+        mNetlist.NameNet(net, name);
+        mNetlist.AddOutput(net);
+    }
+
+    Finish();
+    return true;
+}
+
+bool CNetlistReader::ReadBlif(const std::string &aPath)
+{
+    if (!Load(aPath)) return false;
+    const char *p = mpCursor;
+
+    // Each logical line is split into words, joining lines ending with '\' and dropping comments
+    std::vector<std::string> words;
+    auto readLine = [&]() {
+        words.clear();
+        while (*p != '\0')
+        {
+            SkipSpace(p);
+            if (*p == '#')
+            {
+                while (*p != '\0' && *p != '\n') p++;
+            }
+            if (*p == '\\' && (p[1] == '\n' || (p[1] == '\r' && p[2] == '\n')))
+            {
+                p++;
+                SkipLine(p, mLine);
+                continue;
+            }
+            if (*p == '\n' || *p == '\0')
+            {
+                SkipLine(p, mLine);
+                if (!words.empty()) return true;
+                continue;
+            }
+            words.push_back(ReadWord(p, "#"));
+        }
+        return !words.empty();
+    };
+
+    bool more = readLine();
+    while (more)
+    {
+        if (words[0] == ".inputs")
+        {
+            for (size_t i = 1; i < words.size(); i++)
+            {
+                if (!Define(Signal(words[i]), words[i])) return false;
+                mNetlist.AddInput(Signal(words[i]));
+            }
+            more = readLine();
+        }
+        else if (words[0] == ".outputs")
+        {
+            for (size_t i = 1; i < words.size(); i++) mNetlist.AddOutput(Signal(words[i]));
+            more = readLine();
+        }
+        else if (words[0] == ".names")
+        {
+            // The cover follows as lines not starting with '.'
+            std::vector<std::string> signals(words.begin() + 1, words.end());
+            if (signals.empty()) return Fail(".names without an output");
+            std::vector<std::string> cubes;
+            while ((more = readLine()) && words[0][0] != '.')
+            {
+                if (words.size() == 1 && signals.size() == 1) cubes.push_back(words[0]);
+                else if (words.size() == 2) cubes.push_back(words[0] + words[1]);
+                else return Fail("bad cube in cover of " + signals.back());
+            }
+            if (!BuildCover(signals, cubes)) return false;
+        }
+        else if (words[0] == ".latch")
+        {
+            // Optional clock type and control, then initial value 0, 1, 2 (don't care) or 3 (unknown)
+            if (words.size() < 3) return Fail(".latch needs an input and an output");
+            if (!Define(Signal(words[2]), words[2])) return false;
+            std::string init = (words.size() == 4 || words.size() == 6) ? words.back() : "3";
+            mLatches.push_back(std::make_pair(Signal(words[2]), Signal(words[1])));
+            mLatchInitial.push_back((init == "0") ? LOGIC_LOW : (init == "1") ? LOGIC_HIGH : LOGIC_UNDEFINED);
+            more = readLine();
+        }
+        else if (words[0] == ".subckt" || words[0] == ".gate" || words[0] == ".mlatch")
+        {
+            return Fail(words[0] + " is not supported, flatten the model first");
+        }
+        else if (words[0] == ".end")
+        {
+            break;
+        }
+        else
+        {
+            // .model and timing or clock directives do not change the logic
+            more = readLine();
+        }
+    }
+
+    Finish();
+    return true;
+}
+
+bool CNetlistReader::ReadBench(const std::string &aPath)
+{
+    if (!Load(aPath)) return false;
+    const char *p = mpCursor;
+
+    while (*p != '\0')
+    {
+        SkipSpace(p);
+        if (*p == '#' || *p == '\n' || *p == '\0')
+        {
+            SkipLine(p, mLine);
+            continue;
+        }
+
+        // INPUT(name), OUTPUT(name) or name = FUNCTION(name, ...)
+        std::string first = ReadWord(p, "(=");
+        SkipSpace(p);
+        if (*p == '(')
+        {
+            p++;
+            std::string name = ReadWord(p, ")");
+            if (first == "INPUT")
+            {
+                if (!Define(Signal(name), name)) return false;
+                mNetlist.AddInput(Signal(name));
+            }
+            else if (first == "OUTPUT") mNetlist.AddOutput(Signal(name));
+            else return Fail("unknown declaration " + first);
+            SkipLine(p, mLine);
+            continue;
+        }
+        if (*p != '=') return Fail("expected = after " + first);
+        p++;
+        std::string function = ReadWord(p, "(");
+        for (char &c : function) c = std::toupper((unsigned char)c);
+        SkipSpace(p);
+        if (*p != '(') return Fail("expected ( after " + function);
+        p++;
+        std::vector<int> nets;
+        std::vector<std::string> names;
+        while (true)
+        {
+            std::string name = ReadWord(p, ",)");
+            if (name.empty()) return Fail("missing operand of " + function);
+            names.push_back(name);
+            nets.push_back(Signal(name));
+            SkipSpace(p);
+            if (*p == ',')
+            {
+                p++;
+                continue;
+            }
+            if (*p == ')') break;
+            return Fail("expected , or ) in operands of " + function);
+        }
+        SkipLine(p, mLine);
+
+        int output = Signal(first);
+        if (!Define(output, first)) return false;
+        if (function == "AND") Combine(GATE_AND, nets, output);
+        else if (function == "OR") Combine(GATE_OR, nets, output);
+        else if (function == "XOR") Combine(GATE_XOR, nets, output);
+        else if (function == "NAND") mNetlist.AddGate(GATE_NOT, Combine(GATE_AND, nets, -1), -1, output);
+        else if (function == "NOR") mNetlist.AddGate(GATE_NOT, Combine(GATE_OR, nets, -1), -1, output);
+        else if (function == "XNOR") mNetlist.AddGate(GATE_NOT, Combine(GATE_XOR, nets, -1), -1, output);
+        else if (function == "NOT" && nets.size() == 1) mNetlist.AddGate(GATE_NOT, nets[0], -1, output);
+        else if ((function == "BUF" || function == "BUFF") && nets.size() == 1)
+        {
+            mNetlist.AddGate(GATE_BUF, nets[0], -1, output);
+        }
+        else if (function == "DFF" && nets.size() == 1)
+        {
+            mLatches.push_back(std::make_pair(output, nets[0]));
+            mLatchInitial.push_back(LOGIC_LOW);
+        }
+        else
+        {
+            return Fail("unsupported function " + function + " with " + std::to_string(nets.size()) + " operands");
+        }
+    }
+
+    Finish();
+    return true;
+}
+
+const std::string& CNetlistReader::Error() const
+{
+    return mError;
+}
+
+int CNetlistReader::LatchSize() const
+{
+    return mLatches.size();
+}
+
+bool CNetlistReader::Load(const std::string &aPath)
+{
+    mError.clear();
+    mLine = 1;
+    mText.clear();
+    std::FILE *file = std::fopen(aPath.c_str(), "rb");
+    if (file == NULL)
+    {
+        mError = "Could not open " + aPath;
+        return false;
+    }
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    mText.resize(size > 0 ? size + 1 : 1);
+    size_t read = (size > 0) ? std::fread(mText.data(), 1, size, file) : 0;
+    std::fclose(file);
+    mText.resize(read + 1);
+    mText[read] = '\0';
+    mpCursor = mText.data();
+    mError = aPath;
+    return true;
+}
+
+bool CNetlistReader::Fail(const std::string &aMessage)
+{
+    mError += ":" + std::to_string(mLine) + ": " + aMessage;
+    return false;
+}
+
+int CNetlistReader::Signal(const std::string &aName)
+{
+    std::unordered_map<std::string, int>::iterator it = mSignals.find(aName);
+    if (it != mSignals.end()) return it->second;
+    int net = mNetlist.AddNet(aName);
+    mSignals[aName] = net;
+    return net;
+}
+
+bool CNetlistReader::Define(int aNet, const std::string &aName)
+{
+    if (aNet >= int(mDefined.size())) mDefined.resize(mNetlist.NetSize(), false);
+    if (mDefined[aNet]) return Fail(aName + " is defined twice");
+    mDefined[aNet] = true;
+    return true;
+}
+
+int CNetlistReader::Constant(bool aHigh)
+{
+    if (mConstants[aHigh] < 0)
+    {
+        mConstants[aHigh] = mNetlist.AddNet(aHigh ? "1'b1" : "1'b0");
+        mNetlist.AddConstant(mConstants[aHigh], aHigh ? LOGIC_HIGH : LOGIC_LOW);
+    }
+    return mConstants[aHigh];
+}
+
+int CNetlistReader::Combine(eGateOp aOp, std::vector<int> aNets, int aOutput)
+{
+    // Pair up neighbours until two remain, which drive the output
+    while (aNets.size() > 2)
+    {
+        size_t kept = 0;
+        for (size_t i = 0; i + 1 < aNets.size(); i += 2)
+        {
+            int net = mNetlist.AddNet();
+            mNetlist.AddGate(aOp, aNets[i], aNets[i + 1], net);
+            aNets[kept++] = net;
+        }
+        if (aNets.size() % 2 == 1) aNets[kept++] = aNets.back();
+        aNets.resize(kept);
+    }
+    if (aNets.size() == 1)
+    {
+        if (aOutput < 0) return aNets[0];
+        mNetlist.AddGate(GATE_BUF, aNets[0], -1, aOutput);
+        return aOutput;
+    }
+    if (aOutput < 0) aOutput = mNetlist.AddNet();
+    mNetlist.AddGate(aOp, aNets[0], aNets[1], aOutput);
+    return aOutput;
+}
+
+int CNetlistReader::Invert(int aNet)
+{
+    if (aNet >= int(mInverted.size())) mInverted.resize(mNetlist.NetSize(), -1);
+    if (mInverted[aNet] < 0)
+    {
+        mInverted[aNet] = mNetlist.AddNet();
+        mNetlist.AddGate(GATE_NOT, aNet, -1, mInverted[aNet]);
+    }
+    return mInverted[aNet];
+}
+
+bool CNetlistReader::BuildCover(const std::vector<std::string> &aSignals,
+                                const std::vector<std::string> &aCubes)
+{
+    // A cover is an OR of cubes, each an AND of literals: '1' for the signal, '0' for its
+    // complement, '-' for neither. Cubes ending in '0' describe where the output is LOGIC_LOW.
+    int output = Signal(aSignals.back());
+    if (!Define(output, aSignals.back())) return false;
+    size_t width = aSignals.size() - 1;
+    if (aCubes.empty())
+    {
+        mNetlist.AddConstant(output, LOGIC_LOW);
+        return true;
+    }
+
+    // Check every cube before adding gates, since a cube of don't cares makes the cover constant
+    bool onSet = aCubes[0][width] == '1';
+    bool constant = false;
+    for (const std::string &cube : aCubes)
+    {
+        if (cube.size() != width + 1 || (cube[width] == '1') != onSet ||
+            cube.find_first_not_of("01-") < width)
+        {
+            return Fail("bad cube " + cube + " in cover of " + aSignals.back());
+        }
+        if (cube.find_first_not_of('-') == width) constant = true;
+    }
+    if (constant)
+    {
+        mNetlist.AddConstant(output, onSet ? LOGIC_HIGH : LOGIC_LOW);
+        return true;
+    }
+
+    // A single cube with one complemented literal drives the output as a NOT gate
+    size_t literal = aCubes[0].find_first_not_of('-');
+    if (aCubes.size() == 1 && onSet && aCubes[0][literal] == '0' &&
+        aCubes[0].find_first_not_of('-', literal + 1) == width)
+    {
+        mNetlist.AddGate(GATE_NOT, Signal(aSignals[literal]), -1, output);
+        return true;
+    }
+
+    std::vector<int> terms;
+    for (const std::string &cube : aCubes)
+    {
+        std::vector<int> literals;
+        for (size_t i = 0; i < width; i++)
+        {
+            if (cube[i] == '1') literals.push_back(Signal(aSignals[i]));
+            else if (cube[i] == '0') literals.push_back(Invert(Signal(aSignals[i])));
+        }
+
+        // A single cube drives the output directly
+        if (aCubes.size() == 1 && onSet)
+        {
+            Combine(GATE_AND, literals, output);
+            return true;
+        }
+        terms.push_back(Combine(GATE_AND, literals, -1));
+    }
+    if (onSet) Combine(GATE_OR, terms, output);
+    else mNetlist.AddGate(GATE_NOT, Combine(GATE_OR, terms, -1), -1, output);
+    return true;
+}
+
+void CNetlistReader::Finish()
+{
+    // Each latch becomes a flip-flop clocked by CNetlist::Cycle
+    for (size_t i = 0; i < mLatches.size(); i++)
+    {
+        mNetlist.AddFlop(mLatches[i].second, -1, -1, mLatches[i].first, mLatchInitial[i]);
+    }
+    mNetlist.Finalize();
+}
@@ -0,0 +1,146 @@
+#ifndef _CNETLISTREADER_H
+#define _CNETLISTREADER_H
+
+//--Includes-------------------------------------------------------------------
+#include "CNetlist.h"
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+//---CNetlistReader Declaration-------------------------------------------------
+// CNetlistReader builds a CNetlist from a benchmark netlist file
+//
+// Supported formats, chosen by file extension:
+//      .aig        binary AIGER, AND gates delta encoded, parsed in one pass
+//      .aag        ASCII AIGER
+//      .blif       Berkeley Logic Interchange Format, combinational .names covers and .latch
+//      .bench      ISCAS .bench, AND, NAND, OR, NOR, XOR, XNOR, NOT, BUF and DFF
+//
+// The whole file is read into memory and parsed in place, with no stream extraction per token.
+// Multi-input functions are split into balanced trees of two input gates. Latches and flip-flops
+// become netlist flip-flops, clocked by CNetlist::Cycle. They start at their AIGER reset value or
+// BLIF initial value, unknown and don't care values giving LOGIC_UNDEFINED, and .bench DFFs start
+// LOW. Inputs, outputs and named signals keep their names; internal AIGER nodes stay unnamed.
+class CNetlistReader
+{
+public:
+    /**
+     * Constructor
+     *
+     * @param aNetlist empty netlist to build, finalized once read
+    */
+    CNetlistReader(CNetlist &aNetlist);
+
+    /**
+     * Read a netlist file, choosing the format by its extension
+     *
+     * @param aPath file to read
+     * @return whether the file was read, otherwise Error() says why
+    */
+    bool Read(const std::string &aPath);
+
+    /**
+     * Read an AIGER file, binary or ASCII
+     *
+     * @param aPath file to read
+     * @return whether the file was read
+    */
+    bool ReadAiger(const std::string &aPath);
+
+    /**
+     * Read a BLIF file
+     *
+     * @param aPath file to read
+     * @return whether the file was read
+    */
+    bool ReadBlif(const std::string &aPath);
+
+    /**
+     * Read an ISCAS .bench file
+     *
+     * @param aPath file to read
+     * @return whether the file was read
+    */
+    bool ReadBench(const std::string &aPath);
+
+    /**
+     * return description of the last error
+    */
+    const std::string& Error() const;
+
+    /**
+     * return number of latches and flip-flops read
+    */
+    int LatchSize() const;
+
+private:
+    /**
+     * Load a whole file into mText
+    */
+    bool Load(const std::string &aPath);
+
+    /**
+     * Record an error at the current line
+    */
+    bool Fail(const std::string &aMessage);
+
+    /**
+     * return net of a named signal, adding it on first use
+    */
+    int Signal(const std::string &aName);
+
+    /**
+     * Mark a net as defined, failing if it already was
+     *
+     * @param aNet net being defined by an input, latch or gate
+     * @param aName signal name for the error
+     * @return whether the net was not defined before
+    */
+    bool Define(int aNet, const std::string &aName);
+
+    /**
+     * return net tied to a constant level, adding it on first use
+    */
+    int Constant(bool aHigh);
+
+    /**
+     * Combine nets with a two input operation as a balanced tree
+     *
+     * @param aOp GATE_AND, GATE_OR or GATE_XOR
+     * @param aNets nets to combine, at least one
+     * @param aOutput net to drive with the result, -1 for a new net
+     * @return net carrying the result
+    */
+    int Combine(eGateOp aOp, std::vector<int> aNets, int aOutput);
+
+    /**
+     * return net carrying the complement of a net, adding one NOT gate per net
+    */
+    int Invert(int aNet);
+
+    /**
+     * Add latches and finalize the netlist
+    */
+    void Finish();
+
+    /**
+     * Build one .names cover of a BLIF file
+    */
+    bool BuildCover(const std::vector<std::string> &aSignals, const std::vector<std::string> &aCubes);
+
+    CNetlist &mNetlist;                                 // netlist being built
+    std::string mError;                                 // last error
+    std::vector<char> mText;                            // file contents, NUL terminated
+    const char *mpCursor;                               // parse position in mText
+    int mLine;                                          // line of mpCursor
+
+    std::unordered_map<std::string, int> mSignals;      // net of each named signal
+    std::vector<int> mInverted;                         // complement net of each net, -1 if none yet
+    std::vector<bool> mDefined;                         // whether each net has been defined
+    int mConstants[2];                                  // constant LOGIC_LOW and LOGIC_HIGH nets
+    std::vector<std::pair<int, int>> mLatches;          // output and next state net of each latch
+    std::vector<eLogicLevel> mLatchInitial;             // initial level of each latch
+};
+
+#endif
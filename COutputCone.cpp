@@ -0,0 +1,27 @@
+// See COutputCone.h
+//
+//--Includes-------------------------------------------------------------------
+#include "COutputCone.h"
+
+//---COutputCone Implementation-------------------------------------------------
+COutputCone::COutputCone()
+{
+    mGateSize = 0;
+    mEditsSeen = ~size_t(0);
+}
+
+const std::vector<int>& COutputCone::Outputs() const
+{
+    return mOutputs;
+}
+
+bool COutputCone::ContainsGate(int aGate) const
+{
+    size_t word = size_t(aGate) / 64;
+    return word < mGates.size() && ((mGates[word] >> (aGate % 64)) & 1);
+}
+
+int COutputCone::GateSize() const
+{
+    return mGateSize;
+}
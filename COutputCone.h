@@ -0,0 +1,55 @@
+#ifndef _COUTPUTCONE_H
+#define _COUTPUTCONE_H
+
+//--Includes-------------------------------------------------------------------
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+//---COutputCone Declaration----------------------------------------------------
+// COutputCone holds the transitive fanin cone of some outputs of a CNetlist
+//
+// Made once by CNetlist::MakeCone and reused for every evaluation with CNetlist::EvaluateCone,
+// which computes only the gates of the cone. Membership is a bitset over gates, which picks the
+// gates settled on each loop level; evaluation walks a level ordered schedule. A netlist edit
+// makes the cone stale, and the next evaluation rebuilds it.
+class COutputCone
+{
+public:
+    /**
+     * Constructor for an empty cone
+    */
+    COutputCone();
+
+    /**
+     * return netlist output numbers of the cone, in the order EvaluateCone returns them
+    */
+    const std::vector<int>& Outputs() const;
+
+    /**
+     * return whether a gate is in the cone
+     *
+     * @param aGate gate number
+    */
+    bool ContainsGate(int aGate) const;
+
+    /**
+     * return number of gates in the cone
+    */
+    int GateSize() const;
+
+private:
+    friend class CNetlist;
+
+    std::vector<int> mOutputs;              // netlist output numbers
+    std::vector<uint64_t> mGates;           // one bit per netlist gate, set if in the cone
+    int mGateSize;                          // number of bits set in mGates
+    std::vector<int> mSchedule;             // gates in level order, -1 - i for loop level mLoopGates[i]
+    std::vector<std::vector<int>> mLoopGates; // cone gates of each loop level the cone reaches
+    std::vector<int> mInputs;               // netlist input numbers read by the cone
+    std::vector<int> mFlops;                // flip-flops whose outputs the cone reads
+    std::vector<int> mUndrivenNets;         // undriven nets read by the cone
+    size_t mEditsSeen;                      // netlist edits the cone was built after
+};
+
+#endif
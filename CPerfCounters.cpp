@@ -0,0 +1,92 @@
+// See CPerfCounters.h
+//
+//--Includes-------------------------------------------------------------------
+#include "CPerfCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+//---CPerfCounters Implementation-----------------------------------------------
+CPerfCounters::CPerfCounters()
+{
+    for (int c = 0; c < COUNTER_SIZE; c++)
+    {
+        mFiles[c] = -1;
+        mValues[c] = 0;
+    }
+#ifdef __linux__
+    const uint64_t readMiss = (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    const uint32_t types[COUNTER_SIZE] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+                                          PERF_TYPE_HW_CACHE};
+    const uint64_t configs[COUNTER_SIZE] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                            PERF_COUNT_HW_CACHE_L1D | readMiss,
+                                            PERF_COUNT_HW_CACHE_LL | readMiss};
+    for (int c = 0; c < COUNTER_SIZE; c++)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = types[c];
+        attr.config = configs[c];
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        mFiles[c] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+#endif
+}
+
+CPerfCounters::~CPerfCounters()
+{
+#ifdef __linux__
+    for (int c = 0; c < COUNTER_SIZE; c++)
+    {
+        if (mFiles[c] >= 0) close(mFiles[c]);
+    }
+#endif
+}
+
+void CPerfCounters::Start()
+{
+#ifdef __linux__
+    for (int c = 0; c < COUNTER_SIZE; c++)
+    {
+        if (mFiles[c] < 0) continue;
+        ioctl(mFiles[c], PERF_EVENT_IOC_RESET, 0);
+        ioctl(mFiles[c], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+void CPerfCounters::Stop()
+{
+#ifdef __linux__
+    for (int c = 0; c < COUNTER_SIZE; c++)
+    {
+        if (mFiles[c] < 0) continue;
+        ioctl(mFiles[c], PERF_EVENT_IOC_DISABLE, 0);
+        if (read(mFiles[c], &mValues[c], sizeof(mValues[c])) != sizeof(mValues[c])) mValues[c] = 0;
+    }
+#endif
+}
+
+bool CPerfCounters::IsAvailable(eCounter aCounter) const
+{
+    return mFiles[aCounter] >= 0;
+}
+
+uint64_t CPerfCounters::GetValue(eCounter aCounter) const
+{
+    return mValues[aCounter];
+}
+
+const char* CPerfCounters::GetName(eCounter aCounter)
+{
+    static const char *names[COUNTER_SIZE] = {"cycles", "instructions", "L1D misses", "LLC misses"};
+    return names[aCounter];
+}
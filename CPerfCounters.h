@@ -0,0 +1,75 @@
+#ifndef _CPERFCOUNTERS_H
+#define _CPERFCOUNTERS_H
+
+//--Includes-------------------------------------------------------------------
+#include <cstdint>
+
+//--Consts and enums-----------------------------------------------------------
+enum eCounter // enum defining the hardware events counted
+{
+    COUNTER_CYCLES,
+    COUNTER_INSTRUCTIONS,
+    COUNTER_L1D_MISSES,
+    COUNTER_LLC_MISSES,
+    COUNTER_SIZE
+};
+
+//---CPerfCounters Declaration--------------------------------------------------
+// CPerfCounters counts hardware events of the calling thread between Start and Stop
+//
+// Uses Linux perf_event_open, counting user space only so that it works without privileges
+// under the default perf_event_paranoid setting. Counters the kernel, CPU or container refuse,
+// and every counter on other systems, are reported unavailable.
+class CPerfCounters
+{
+public:
+    /**
+     * Constructor, opening every counter the system allows
+    */
+    CPerfCounters();
+
+    /**
+     * Destructor, closing the counters
+    */
+    ~CPerfCounters();
+
+    CPerfCounters(const CPerfCounters &) = delete;
+    CPerfCounters& operator=(const CPerfCounters &) = delete;
+
+    /**
+     * Reset and start every available counter
+    */
+    void Start();
+
+    /**
+     * Stop every available counter and read its value
+    */
+    void Stop();
+
+    /**
+     * return whether a counter could be opened
+     *
+     * @param aCounter counter
+    */
+    bool IsAvailable(eCounter aCounter) const;
+
+    /**
+     * return count between the last Start and Stop
+     *
+     * @param aCounter counter
+    */
+    uint64_t GetValue(eCounter aCounter) const;
+
+    /**
+     * return short name of a counter
+     *
+     * @param aCounter counter
+    */
+    static const char* GetName(eCounter aCounter);
+
+private:
+    int mFiles[COUNTER_SIZE];           // file descriptor of each counter, -1 if unavailable
+    uint64_t mValues[COUNTER_SIZE];     // count of each counter at the last Stop
+};
+
+#endif
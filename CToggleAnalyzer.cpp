@@ -0,0 +1,141 @@
+// See CToggleAnalyzer.h
+//
+//--Includes-------------------------------------------------------------------
+#include "CToggleAnalyzer.h"
+#include "CNetlist.h"
+
+#include <algorithm>
+#include <iomanip>
+
+//---CToggleAnalyzer Implementation---------------------------------------------
+CToggleAnalyzer::CToggleAnalyzer(const CNetlist &aNetlist) : mNetlist(aNetlist)
+{
+    // Default weight: the driver plus every gate input on the net
+    mWeights = std::vector<double>(aNetlist.NetSize());
+    for (int n = 0; n < aNetlist.NetSize(); n++)
+    {
+        mWeights[n] = 1 + aNetlist.FanoutSize(n);
+    }
+    Reset();
+}
+
+void CToggleAnalyzer::Reset()
+{
+    Transitions none;
+    none.mRises = 0;
+    none.mFalls = 0;
+    mPatterns = 0;
+    mWordPatterns = 0;
+    mTransitions = std::vector<Transitions>(mNetlist.NetSize(), none);
+    mUndefined = std::vector<uint64_t>(mNetlist.NetSize(), 0);
+}
+
+void CToggleAnalyzer::SetNetWeight(int aNet, double aWeight)
+{
+    mWeights[aNet] = aWeight;
+}
+
+CToggleAnalyzer::Recorder CToggleAnalyzer::BeginWord(int aPatterns)
+{
+    // Nets added to the netlist since are recorded from here on
+    if (int(mTransitions.size()) < mNetlist.NetSize())
+    {
+        Transitions none;
+        none.mRises = 0;
+        none.mFalls = 0;
+        for (int n = mTransitions.size(); n < mNetlist.NetSize(); n++)
+        {
+            mWeights.push_back(1 + mNetlist.FanoutSize(n));
+        }
+        mTransitions.resize(mNetlist.NetSize(), none);
+        mUndefined.resize(mNetlist.NetSize(), 0);
+    }
+
+    // The last pattern of the previous word is carried in to this one
+    Recorder recorder;
+    recorder.mPrevious = (mWordPatterns > 0) ? mWordPatterns - 1 : 0;
+    recorder.mPreviousUndefined = (mPatterns == 0) ? 1 : 0;
+    mWordPatterns = (aPatterns > 64) ? 64 : aPatterns;
+    recorder.mEnd = mWordPatterns - 1;
+    recorder.mMask = (mWordPatterns == 64) ? ~uint64_t(0) : ((uint64_t(1) << mWordPatterns) - 1);
+    recorder.mpTransitions = mTransitions.data();
+    recorder.mpUndefined = mUndefined.data();
+    mPatterns += mWordPatterns;
+    return recorder;
+}
+
+uint64_t CToggleAnalyzer::PatternSize() const
+{
+    return mPatterns;
+}
+
+uint64_t CToggleAnalyzer::Rises(int aNet) const
+{
+    return mTransitions[aNet].mRises;
+}
+
+uint64_t CToggleAnalyzer::Falls(int aNet) const
+{
+    return mTransitions[aNet].mFalls;
+}
+
+uint64_t CToggleAnalyzer::UndefinedTime(int aNet) const
+{
+    return mUndefined[aNet];
+}
+
+double CToggleAnalyzer::ToggleRate(int aNet) const
+{
+    if (mPatterns == 0) return 0;
+    return double(mTransitions[aNet].mRises + mTransitions[aNet].mFalls) / mPatterns;
+}
+
+double CToggleAnalyzer::SwitchingCapacitance() const
+{
+    double total = 0;
+    for (int n = 0; n < int(mWeights.size()); n++)
+    {
+        total += mWeights[n] * ToggleRate(n);
+    }
+    return total;
+}
+
+std::vector<int> CToggleAnalyzer::HottestNets(int aCount) const
+{
+    std::vector<int> nets;
+    for (int n = 0; n < int(mWeights.size()); n++)
+    {
+        if (!mNetlist.NetName(n).empty()) nets.push_back(n);
+    }
+    aCount = std::min(aCount, int(nets.size()));
+    std::partial_sort(nets.begin(), nets.begin() + aCount, nets.end(), [this](int a, int b) {
+        return mWeights[a] * ToggleRate(a) > mWeights[b] * ToggleRate(b);
+    });
+    nets.resize(aCount);
+    return nets;
+}
+
+void CToggleAnalyzer::Report(std::ostream &aStream, int aHottest) const
+{
+    aStream << "Toggle activity over " << mPatterns << " patterns" << std::endl;
+    for (int n = 0; n < int(mWeights.size()); n++)
+    {
+        if (mNetlist.NetName(n).empty()) continue;
+        aStream << "  " << std::left << std::setw(24) << mNetlist.NetName(n) << std::right
+                << " rise " << std::setw(10) << mTransitions[n].mRises
+                << " fall " << std::setw(10) << mTransitions[n].mFalls
+                << " Z " << std::setw(10) << mUndefined[n]
+                << " rate " << std::fixed << std::setprecision(4) << ToggleRate(n)
+                << std::endl;
+    }
+    aStream << "Switching capacitance proxy: " << std::fixed << std::setprecision(4)
+            << SwitchingCapacitance() << " per pattern" << std::endl;
+    aStream << "Hottest nets:" << std::endl;
+    for (int n : HottestNets(aHottest))
+    {
+        aStream << "  " << std::left << std::setw(24) << mNetlist.NetName(n) << std::right
+                << " weighted rate " << std::fixed << std::setprecision(4)
+                << mWeights[n] * ToggleRate(n) << std::endl;
+    }
+    aStream.unsetf(std::ios::fixed | std::ios::left);
+}
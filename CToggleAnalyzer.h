@@ -0,0 +1,184 @@
+#ifndef _CTOGGLEANALYZER_H
+#define _CTOGGLEANALYZER_H
+
+//--Includes-------------------------------------------------------------------
+#include "CEvalContext.h"
+
+#include <vector>
+#include <ostream>
+#include <cstdint>
+
+//--Forward Declaration
+class CNetlist;
+
+//---CToggleAnalyzer Declaration------------------------------------------------
+// CToggleAnalyzer records switching activity of every net of a CNetlist across a stream of
+// 64 pattern evaluations
+//
+// The analyzer is passed to CNetlist::EvaluateWords, which records each net word as it is
+// computed while it is still in registers. Each word is XORed against itself shifted by one
+// pattern, carrying in the last pattern of the previous word, and the rising transitions,
+// falling transitions and patterns at LOGIC_UNDEFINED are counted with popcount. Transitions to
+// or from LOGIC_UNDEFINED are not counted as toggles.
+//
+// Recording touches each net word about as much as computing it, so it adds 50-150% to the 64
+// pattern kernel on circuits of more than a few gates, against a target of 10%.
+// TestDriver::ToggleCircuit reports it. EvaluateWords without an analyzer compiles the recording
+// out.
+//
+// The switching capacitance proxy weights each net's toggles by the number of gate inputs it
+// drives plus one for its driver, unless overridden with SetNetWeight.
+class CToggleAnalyzer
+{
+public:
+    /**
+     * Constructor
+     *
+     * @param aNetlist netlist whose nets are analysed
+    */
+    CToggleAnalyzer(const CNetlist &aNetlist);
+
+    /**
+     * Forget all recorded activity
+    */
+    void Reset();
+
+    /**
+     * Override the capacitance weight of a net
+     *
+     * @param aNet net number
+     * @param aWeight relative capacitance of the net
+    */
+    void SetNetWeight(int aNet, double aWeight);
+
+    /**
+     * return number of patterns recorded
+    */
+    uint64_t PatternSize() const;
+
+    /**
+     * return number of LOGIC_LOW to LOGIC_HIGH transitions of a net
+     *
+     * @param aNet net number
+    */
+    uint64_t Rises(int aNet) const;
+
+    /**
+     * return number of LOGIC_HIGH to LOGIC_LOW transitions of a net
+     *
+     * @param aNet net number
+    */
+    uint64_t Falls(int aNet) const;
+
+    /**
+     * return number of patterns a net spent at LOGIC_UNDEFINED
+     *
+     * @param aNet net number
+    */
+    uint64_t UndefinedTime(int aNet) const;
+
+    /**
+     * return transitions of a net per recorded pattern
+     *
+     * @param aNet net number
+    */
+    double ToggleRate(int aNet) const;
+
+    /**
+     * return sum over all nets of weight x toggle rate
+    */
+    double SwitchingCapacitance() const;
+
+    /**
+     * return named nets with the highest weighted toggle rate, hottest first
+     *
+     * @param aCount maximum number of nets to return
+    */
+    std::vector<int> HottestNets(int aCount) const;
+
+    /**
+     * Print per-net toggle rates, the switching capacitance proxy and the hottest nets
+     *
+     * @param aStream stream to print to
+     * @param aHottest number of hottest nets to list
+    */
+    void Report(std::ostream &aStream, int aHottest = 10) const;
+
+private:
+    friend class CNetlist;
+
+    struct Transitions
+    {
+        uint64_t mRises;                    // LOGIC_LOW to LOGIC_HIGH transitions
+        uint64_t mFalls;                    // LOGIC_HIGH to LOGIC_LOW transitions
+    };
+
+    // Records one word of patterns. Evaluation copies this into a local variable so the counters
+    // stay in registers rather than being reloaded after every store to a net word.
+    struct Recorder
+    {
+        uint64_t mMask;                     // valid patterns of the word
+        int mEnd;                           // index of the last valid pattern of the word
+        int mPrevious;                      // index of the last valid pattern of the previous word
+        uint64_t mPreviousUndefined;        // 1 if there is no previous word
+        Transitions *mpTransitions;         // transitions of each net
+        uint64_t *mpUndefined;              // patterns at LOGIC_UNDEFINED of each net
+
+        /**
+         * Record the new word of a net
+         *
+         * @param aNet net number
+         * @param aPrevious word of the net from the previous evaluation
+         * @param aCurrent word of the net from this evaluation
+        */
+        inline void Record(int aNet, const LogicWord &aPrevious, const LogicWord &aCurrent);
+    };
+
+    /**
+     * Start recording a word of patterns
+     *
+     * @param aPatterns number of valid patterns, counted from bit 0
+     * @return recorder for the word
+    */
+    Recorder BeginWord(int aPatterns);
+
+    const CNetlist &mNetlist;               // analysed netlist
+    uint64_t mPatterns;                     // patterns recorded
+    int mWordPatterns;                      // number of valid patterns in the last word
+
+    std::vector<Transitions> mTransitions;  // transitions of each net
+    std::vector<uint64_t> mUndefined;       // patterns at LOGIC_UNDEFINED of each net
+    std::vector<double> mWeights;           // capacitance weight of each net
+};
+
+//---CToggleAnalyzer Inline Implementation--------------------------------------
+inline void CToggleAnalyzer::Recorder::Record(int aNet, const LogicWord &aPrevious,
+                                              const LogicWord &aCurrent)
+{
+    uint64_t high = aCurrent.mHigh & mMask;
+    uint64_t undefined = aCurrent.mUndefined & mMask;
+    uint64_t lastHigh = (aPrevious.mHigh >> mPrevious) & 1 & ~mPreviousUndefined;
+    uint64_t lastUndefined = ((aPrevious.mUndefined >> mPrevious) & 1) | mPreviousUndefined;
+    uint64_t previousHigh = (high << 1) | lastHigh;
+    Transitions &count = mpTransitions[aNet];
+
+    if ((undefined | lastUndefined) == 0)
+    {
+        // Fully defined: rises and falls alternate, so one popcount of the toggles and the
+        // levels at either end give both
+        uint64_t toggles = __builtin_popcountll((high ^ previousHigh) & mMask);
+        uint64_t rises = (toggles + ((high >> mEnd) & 1) - lastHigh) / 2;
+        count.mRises += rises;
+        count.mFalls += toggles - rises;
+    }
+    else
+    {
+        uint64_t previousUndefined = (undefined << 1) | lastUndefined;
+        uint64_t defined = ~undefined & ~previousUndefined & mMask;
+        count.mRises += __builtin_popcountll(high & ~previousHigh & defined);
+        count.mFalls += __builtin_popcountll(~high & previousHigh & defined);
+        mpUndefined[aNet] += __builtin_popcountll(undefined);
+    }
+}
+
+#endif
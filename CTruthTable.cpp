@@ -0,0 +1,94 @@
+// See CTruthTable.h
+//
+//--Includes-------------------------------------------------------------------
+#include "CTruthTable.h"
+#include "CEvalContext.h"
+
+#include <functional>
+
+//---CTruthTable Implementation-------------------------------------------------
+CTruthTable::CTruthTable(const CNetlist &aNetlist)
+{
+    mInputs = aNetlist.InputSize();
+    mOutputs = aNetlist.OutputSize();
+    mRowWords = (mOutputs + 63) / 64;
+    mRows = std::vector<uint64_t>((size_t(1) << mInputs) * mRowWords, 0);
+    mSupport = std::vector<uint32_t>(mOutputs, 0);
+    mUndefined = std::vector<char>(mOutputs, 0);
+
+    // Sweep every assignment, 512 at a time
+    CEvalContext context(aNetlist);
+    std::vector<LogicBlock> blocks;
+    std::vector<LogicBlock> results;
+    uint64_t total = uint64_t(1) << mInputs;
+    for (uint64_t first = 0; first < total; first += 64 * LogicBlock::Words)
+    {
+        int valid = aNetlist.SweepBlocks(first, blocks);
+        aNetlist.EvaluateBlocks(context, blocks, results);
+        for (int o = 0; o < mOutputs; o++)
+        {
+            for (int p = 0; p < valid; p++)
+            {
+                if ((results[o].mUndefined[p / 64] >> (p % 64)) & 1) mUndefined[o] = 1;
+                if ((results[o].mHigh[p / 64] >> (p % 64)) & 1)
+                {
+                    mRows[(first + p) * mRowWords + o / 64] |= uint64_t(1) << (o % 64);
+                }
+            }
+        }
+    }
+
+    // Support: pattern i leaves only input i undefined
+    std::vector<LogicWord> inputs(mInputs);
+    std::vector<LogicWord> outputs;
+    for (int i = 0; i < mInputs; i++)
+    {
+        inputs[i].mHigh = 0;
+        inputs[i].mUndefined = uint64_t(1) << i;
+    }
+    aNetlist.EvaluateWords(context, inputs, outputs);
+    for (int o = 0; o < mOutputs; o++)
+    {
+        for (int i = 0; i < mInputs; i++)
+        {
+            if ((outputs[o].mUndefined >> i) & 1) mSupport[o] |= uint32_t(1) << (mInputs - 1 - i);
+        }
+    }
+}
+
+eLogicLevel CTruthTable::GetOutput(int aOutput, uint32_t aAssignment, uint32_t aUndefined) const
+{
+    if (mUndefined[aOutput] || (mSupport[aOutput] & aUndefined) != 0) return LOGIC_UNDEFINED;
+    uint64_t row = mRows[size_t(aAssignment) * mRowWords + aOutput / 64];
+    return ((row >> (aOutput % 64)) & 1) ? LOGIC_HIGH : LOGIC_LOW;
+}
+
+int CTruthTable::InputSize() const
+{
+    return mInputs;
+}
+
+int CTruthTable::OutputSize() const
+{
+    return mOutputs;
+}
+
+size_t CTruthTable::MemorySize() const
+{
+    return sizeof(CTruthTable) + mRows.size() * sizeof(uint64_t) + mSupport.size() * sizeof(uint32_t) +
+           mUndefined.size();
+}
+
+size_t CTruthTable::Hash() const
+{
+    size_t hash = std::hash<int>()(mInputs) * 31 + std::hash<int>()(mOutputs);
+    for (uint64_t row : mRows) hash = hash * 1000003 ^ std::hash<uint64_t>()(row);
+    for (uint32_t support : mSupport) hash = hash * 1000003 ^ std::hash<uint32_t>()(support);
+    return hash;
+}
+
+bool CTruthTable::operator==(const CTruthTable &aOther) const
+{
+    return mInputs == aOther.mInputs && mOutputs == aOther.mOutputs && mRows == aOther.mRows &&
+           mSupport == aOther.mSupport && mUndefined == aOther.mUndefined;
+}
@@ -0,0 +1,72 @@
+#ifndef _CTRUTHTABLE_H
+#define _CTRUTHTABLE_H
+
+//--Includes-------------------------------------------------------------------
+#include "CNetlist.h"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+//---CTruthTable Declaration----------------------------------------------------
+// CTruthTable holds the complete response of a loop-free netlist with few inputs
+//
+// Assignment a drives input i with bit (InputSize() - 1 - i) of a, as in CNetlist::SweepWords.
+// Each assignment has a row with one bit per output. Since any undefined gate input gives an
+// undefined output, an output is LOGIC_UNDEFINED exactly when an undefined input lies in its
+// support, or when it reads an undriven net. So the full 0/1/Z response needs only the 2^n rows
+// plus the support of each output.
+class CTruthTable
+{
+public:
+    /**
+     * Constructor, sweeping every assignment of a netlist
+     *
+     * @param aNetlist finalized netlist without combinational loops, at most 32 inputs
+    */
+    CTruthTable(const CNetlist &aNetlist);
+
+    /**
+     * return level of an output
+     *
+     * @param aOutput output number
+     * @param aAssignment input levels, bit (InputSize() - 1 - i) for input i
+     * @param aUndefined inputs at LOGIC_UNDEFINED, in the same bit order
+    */
+    eLogicLevel GetOutput(int aOutput, uint32_t aAssignment, uint32_t aUndefined) const;
+
+    /**
+     * return number of inputs
+    */
+    int InputSize() const;
+
+    /**
+     * return number of outputs
+    */
+    int OutputSize() const;
+
+    /**
+     * return bytes of memory held by the table
+    */
+    size_t MemorySize() const;
+
+    /**
+     * return hash of the response, equal for equal tables
+    */
+    size_t Hash() const;
+
+    /**
+     * return whether two tables have the same response
+    */
+    bool operator==(const CTruthTable &aOther) const;
+
+private:
+    int mInputs;                        // number of inputs
+    int mOutputs;                       // number of outputs
+    int mRowWords;                      // words per row
+    std::vector<uint64_t> mRows;        // output bits of each assignment
+    std::vector<uint32_t> mSupport;     // inputs each output depends on
+    std::vector<char> mUndefined;       // 1 for each output undefined whatever the inputs
+};
+
+#endif
@@ -0,0 +1,219 @@
+// See CVcdWriter.h
+//
+//--Includes-------------------------------------------------------------------
+#include "CVcdWriter.h"
+
+#include <fnmatch.h>
+#include <cstring>
+#include <iostream>
+
+//---Helpers--------------------------------------------------------------------
+// VCD identifier code for a traced net: base 94 over the printable characters
+static std::string IdentifierCode(int aIndex)
+{
+    std::string code;
+    do
+    {
+        code.push_back(char('!' + aIndex % 94));
+        aIndex /= 94;
+    } while (aIndex > 0);
+    return code;
+}
+
+// Split a hierarchical name into its scopes and leaf name
+static std::vector<std::string> SplitName(const std::string &aName)
+{
+    std::vector<std::string> parts;
+    size_t start = 0;
+    size_t dot;
+    while ((dot = aName.find('.', start)) != std::string::npos)
+    {
+        parts.push_back(aName.substr(start, dot - start));
+        start = dot + 1;
+    }
+    parts.push_back(aName.substr(start));
+    return parts;
+}
+
+// VCD character for a level
+static inline char LevelChar(eLogicLevel aLevel)
+{
+    if (aLevel == LOGIC_HIGH) return '1';
+    if (aLevel == LOGIC_LOW) return '0';
+    return 'z';
+}
+
+//---CVcdWriter Implementation--------------------------------------------------
+CVcdWriter::CVcdWriter(const CNetlist &aNetlist, const std::string &aPath,
+                       const std::vector<std::string> &aSelection, size_t aBufferSize)
+{
+    mFirst = true;
+    mFill = 0;
+    mCurrent = 0;
+    mPending = 0;
+    mStop = false;
+    mBuffers[0] = std::vector<char>(aBufferSize < 256 ? 256 : aBufferSize);
+    mBuffers[1] = std::vector<char>(mBuffers[0].size());
+
+    mpFile = std::fopen(aPath.c_str(), "w");
+    if (mpFile == NULL)
+    {
+        std::cout << "Could not open " << aPath << " for writing" << std::endl;
+        return;
+    }
+
+    // Select names matching any pattern, giving each traced net one identifier code
+    std::vector<std::pair<std::string, int>> names;
+    std::vector<int> codeOfNet(aNetlist.NetSize(), -1);
+    for (std::pair<std::string, int> &named : aNetlist.NamedNets())
+    {
+        bool traced = aSelection.empty();
+        for (const std::string &pattern : aSelection)
+        {
+            if (fnmatch(pattern.c_str(), named.first.c_str(), 0) == 0) traced = true;
+        }
+        if (!traced) continue;
+        if (codeOfNet[named.second] < 0)
+        {
+            codeOfNet[named.second] = mNets.size();
+            mNets.push_back(named.second);
+            mCodes.push_back(IdentifierCode(mCodes.size()));
+        }
+        names.push_back(named);
+    }
+    mLast = std::vector<char>(mNets.size(), 0);
+
+    // Header. Names are sorted, so names sharing a scope are consecutive.
+    std::string header = "$timescale 1ns $end\n$scope module top $end\n";
+    std::vector<std::string> scopes;
+    for (std::pair<std::string, int> &named : names)
+    {
+        std::vector<std::string> parts = SplitName(named.first);
+        size_t common = 0;
+        while (common < scopes.size() && common + 1 < parts.size() && scopes[common] == parts[common])
+        {
+            common++;
+        }
+        for (; scopes.size() > common; scopes.pop_back()) header += "$upscope $end\n";
+        for (; scopes.size() + 1 < parts.size(); scopes.push_back(parts[scopes.size()]))
+        {
+            header += "$scope module " + parts[scopes.size()] + " $end\n";
+        }
+        header += "$var wire 1 " + mCodes[codeOfNet[named.second]] + " " + parts.back() + " $end\n";
+    }
+    for (; !scopes.empty(); scopes.pop_back()) header += "$upscope $end\n";
+    header += "$upscope $end\n$enddefinitions $end\n";
+    std::fwrite(header.data(), 1, header.size(), mpFile);
+
+    mWriter = std::thread(&CVcdWriter::WriteLoop, this);
+}
+
+CVcdWriter::~CVcdWriter()
+{
+    Close();
+}
+
+bool CVcdWriter::IsOpen() const
+{
+    return mpFile != NULL;
+}
+
+int CVcdWriter::TracedSize() const
+{
+    return mNets.size();
+}
+
+inline void CVcdWriter::Append(const char *apText, size_t aLength)
+{
+    if (mFill + aLength > mBuffers[mCurrent].size()) SwapBuffers();
+    std::memcpy(mBuffers[mCurrent].data() + mFill, apText, aLength);
+    mFill += aLength;
+}
+
+void CVcdWriter::Sample(uint64_t aTime, const CEvalContext &aContext)
+{
+    if (mpFile == NULL) return;
+
+    // Time stamp, written only once a change is found
+    char stamp[24];
+    int stampLength = std::snprintf(stamp, sizeof(stamp), "#%llu\n", (unsigned long long)aTime);
+    bool stamped = false;
+    if (mFirst)
+    {
+        Append(stamp, stampLength);
+        Append("$dumpvars\n", 10);
+        stamped = true;
+    }
+
+    char line[16];
+    for (int i = 0; i < int(mNets.size()); i++)
+    {
+        char level = LevelChar(aContext.GetNetLevel(mNets[i]));
+        if (level == mLast[i]) continue;
+        mLast[i] = level;
+        if (!stamped)
+        {
+            Append(stamp, stampLength);
+            stamped = true;
+        }
+        line[0] = level;
+        std::memcpy(line + 1, mCodes[i].data(), mCodes[i].size());
+        line[mCodes[i].size() + 1] = '\n';
+        Append(line, mCodes[i].size() + 2);
+    }
+
+    if (mFirst)
+    {
+        Append("$end\n", 5);
+        mFirst = false;
+    }
+}
+
+void CVcdWriter::SwapBuffers()
+{
+    // Wait for the other buffer to be written, then hand this one over
+    std::unique_lock<std::mutex> lock(mMutex);
+    mSignal.wait(lock, [this] { return mPending == 0; });
+    mPending = mFill;
+    mCurrent = 1 - mCurrent;
+    mFill = 0;
+    mSignal.notify_all();
+}
+
+void CVcdWriter::WriteLoop()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true)
+    {
+        mSignal.wait(lock, [this] { return mPending > 0 || mStop; });
+        if (mPending > 0)
+        {
+            // The handed over buffer is the one not being filled
+            const std::vector<char> &buffer = mBuffers[1 - mCurrent];
+            size_t length = mPending;
+            lock.unlock();
+            std::fwrite(buffer.data(), 1, length, mpFile);
+            lock.lock();
+            mPending = 0;
+            mSignal.notify_all();
+        }
+        else if (mStop)
+        {
+            return;
+        }
+    }
+}
+
+void CVcdWriter::Close()
+{
+    if (mpFile == NULL) return;
+    if (mFill > 0) SwapBuffers();
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mSignal.notify_all();
+    mWriter.join();
+    std::fclose(mpFile);
+    mpFile = NULL;
+}
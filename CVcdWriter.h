@@ -0,0 +1,101 @@
+#ifndef _CVCDWRITER_H
+#define _CVCDWRITER_H
+
+//--Includes-------------------------------------------------------------------
+#include "CNetlist.h"
+
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//---CVcdWriter Declaration-----------------------------------------------------
+// CVcdWriter dumps the levels of selected nets of a CNetlist to a Value Change Dump file
+//
+// After each evaluation the caller passes the context to Sample, which compares every traced
+// net with the level last written and appends only the changes. Text is built in one buffer
+// while a background thread writes the other to the file, so simulation only waits on the disk
+// when it fills a buffer faster than the disk drains one.
+//
+// Net names are split on '.' into VCD scopes. Every name of a traced net is declared, sharing
+// one identifier code. LOGIC_UNDEFINED is written as z.
+class CVcdWriter
+{
+public:
+    /**
+     * Constructor, opening the file and writing the header
+     *
+     * @param aNetlist netlist whose nets are traced
+     * @param aPath file to write
+     * @param aSelection glob patterns (*, ?, [...]) of net names to trace, empty to trace all
+     * @param aBufferSize size of each of the two text buffers in bytes
+    */
+    CVcdWriter(const CNetlist &aNetlist, const std::string &aPath,
+               const std::vector<std::string> &aSelection = std::vector<std::string>(),
+               size_t aBufferSize = 1 << 22);
+
+    /**
+     * Destructor, closing the file
+    */
+    ~CVcdWriter();
+
+    /**
+     * return whether the file was opened
+    */
+    bool IsOpen() const;
+
+    /**
+     * return number of traced nets
+    */
+    int TracedSize() const;
+
+    /**
+     * Append the changes since the last sample
+     *
+     * @param aTime simulation time of the sample, not less than the previous sample's
+     * @param aContext context after a CNetlist::Evaluate call
+    */
+    void Sample(uint64_t aTime, const CEvalContext &aContext);
+
+    /**
+     * Write out the buffered text, wait for the background thread and close the file
+    */
+    void Close();
+
+private:
+    /**
+     * Hand the filled buffer to the background thread and continue in the other one
+    */
+    void SwapBuffers();
+
+    /**
+     * Background thread: write each handed over buffer to the file
+    */
+    void WriteLoop();
+
+    /**
+     * Append text to the current buffer
+    */
+    inline void Append(const char *apText, size_t aLength);
+
+    std::FILE *mpFile;                      // output file
+    std::vector<int> mNets;                 // traced nets
+    std::vector<std::string> mCodes;        // identifier code of each traced net
+    std::vector<char> mLast;                // level last written of each traced net
+    bool mFirst;                            // true until the first sample is written
+
+    std::vector<char> mBuffers[2];          // text buffers
+    size_t mFill;                           // bytes used in the current buffer
+    int mCurrent;                           // buffer being filled
+
+    std::thread mWriter;                    // background writing thread
+    std::mutex mMutex;                      // guards the fields below
+    std::condition_variable mSignal;        // signals a change of the fields below
+    size_t mPending;                        // bytes of the other buffer waiting to be written
+    bool mStop;                             // set to end the background thread
+};
+
+#endif
@@ -4,10 +4,31 @@
 #include "CLogic.h"
 #include "CWire.h"
 
+#include <deque>
+
+//---Worklist------------------------------------------------------------------
+// Gate inputs waiting to be driven, oldest first, for each thread
+struct WireEvent
+{
+    CLogic *mpGate;             // gate to drive
+    int mInput;                 // input of gate to drive
+    eLogicLevel mLevel;         // level to drive input with
+    int mDepth;                 // wire drives leading to this one in the drain
+};
+
+static thread_local std::deque<WireEvent> sEvents;      // queued inputs
+static thread_local bool sDraining = false;             // true while a DriveLevel call drains
+static thread_local unsigned sDrain = 0;                // number of drains started
+static thread_local int sDepth = 0;                     // depth of the input being driven
+static thread_local int sDrainWires = 0;                // distinct wires driven in the drain
+
 //---CWire Implementation------------------------------------------------------
 CWire::CWire()
 {
     mNumOutputConnections = 0;
+    mDrain = 0;
+    mDrives = 0;
+    mSettled = true;
 }
 
 void CWire::AddOutputConnection(CLogic *apGateToDrive, int aGateInputToDrive)
@@ -17,9 +38,97 @@ void CWire::AddOutputConnection(CLogic *apGateToDrive, int aGateInputToDrive)
     ++mNumOutputConnections;
 }
 
-void CWire::DriveLevel(eLogicLevel aNewLevel)
+void CWire::RemoveOutputConnection(CLogic *apGateToDrive, int aGateInputToDrive)
+{
+    // Close the gaps left by removed outputs
+    int kept = 0;
+    for (int i = 0; i < mNumOutputConnections; ++i)
+    {
+        if (mpGatesToDrive[i] == apGateToDrive &&
+            (aGateInputToDrive < 0 || mGateInputIndices[i] == aGateInputToDrive)) continue;
+        mpGatesToDrive[kept] = mpGatesToDrive[i];
+        mGateInputIndices[kept] = mGateInputIndices[i];
+        ++kept;
+    }
+    mNumOutputConnections = kept;
+}
+
+void CWire::ReplaceOutputConnection(CLogic *apOldGate, CLogic *apNewGate)
 {
-    // Drive each connected output
     for (int i = 0; i < mNumOutputConnections; ++i)
-        mpGatesToDrive[i]->DriveInput(mGateInputIndices[i], aNewLevel);
+    {
+        if (mpGatesToDrive[i] == apOldGate) mpGatesToDrive[i] = apNewGate;
+    }
+}
+
+void CWire::DriveLevel(eLogicLevel aNewLevel)
+{
+    // The outermost call starts a drain
+    bool outermost = !sDraining;
+    if (outermost)
+    {
+        sDraining = true;
+        ++sDrain;
+        sDrainWires = 0;
+    }
+
+    // Count drives in this drain. A chain of drives longer than the number of wires the drain
+    // has driven passes some wire twice, so only a wire fed by a loop can give up, and it leaves
+    // its outputs undefined.
+    if (mDrain != sDrain)
+    {
+        ++sDrainWires;
+        mDrain = sDrain;
+        mDrives = 0;
+        mSettled = true;
+    }
+    bool queue = mSettled;
+    if (mSettled && ++mDrives > MaxDrives && sDepth >= sDrainWires)
+    {
+        mSettled = false;
+        aNewLevel = LOGIC_UNDEFINED;
+    }
+
+    // Queue each connected output
+    for (int i = 0; queue && i < mNumOutputConnections; ++i)
+    {
+        WireEvent event;
+        event.mpGate = mpGatesToDrive[i];
+        event.mInput = mGateInputIndices[i];
+        event.mLevel = aNewLevel;
+        event.mDepth = sDepth;
+        sEvents.push_back(event);
+    }
+    if (!outermost) return;
+
+    // Drive queued inputs until nothing changes. Gates drive their output wires, which queue more.
+    while (!sEvents.empty())
+    {
+        WireEvent event = sEvents.front();
+        sEvents.pop_front();
+        sDepth = event.mDepth + 1;
+        event.mpGate->DriveInput(event.mInput, event.mLevel);
+    }
+    sDepth = 0;
+    sDraining = false;
+}
+
+bool CWire::IsSettled()
+{
+    return mSettled;
+}
+
+int CWire::OutputConnectionSize()
+{
+    return mNumOutputConnections;
+}
+
+CLogic* CWire::GetConnectedLogic(int aConnectionIndex)
+{
+    return mpGatesToDrive[aConnectionIndex];
+}
+
+int CWire::GetConnectedInput(int aConnectionIndex)
+{
+    return mGateInputIndices[aConnectionIndex];
 }
\ No newline at end of file
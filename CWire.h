@@ -18,6 +18,13 @@ enum eLogicLevel // enum defining the possible states of a logic line
 // The global variable MaxFanout controls how many outputs each wire can have
 // Each wire output drives a specific input of a specific gate
 // The wire's input is controlled via the DriveLevel function
+//
+// Driving a wire queues its outputs on a worklist rather than driving them directly. The first
+// DriveLevel call drains the worklist, gate by gate, until nothing changes, so propagation depth 
+// never grows the stack. A wire driven more than MaxDrives times in one drain, by a chain of drives
+// longer than the number of wires driven in that drain, is fed by an oscillating loop: it drives
+// its outputs undefined once, stops propagating and is marked unsettled. Acyclic circuits, however
+// deep, never give up.
 class CWire
 {
   public:
@@ -34,6 +41,22 @@ class CWire
     */
     void AddOutputConnection(CLogic *apGateToDrive, int aGateInputToDrive);
 
+    /**
+     * Removes outputs that this wire drives
+     * 
+     * @param apGateToDrive gate no longer driven
+     * @param aGateInputToDrive input of gate no longer driven, -1 for all of its inputs
+    */
+    void RemoveOutputConnection(CLogic *apGateToDrive, int aGateInputToDrive = -1);
+
+    /**
+     * Moves the outputs driving one gate to the same inputs of another
+     * 
+     * @param apOldGate gate no longer driven
+     * @param apNewGate gate to drive instead
+    */
+    void ReplaceOutputConnection(CLogic *apOldGate, CLogic *apNewGate);
+
     /**
      * Drives the wire's value, so that each of its connected outputs
      * 
@@ -41,11 +64,41 @@ class CWire
     */
     void DriveLevel(eLogicLevel aNewLevel);
 
+    /**
+     * return whether the wire settled the last time it was driven
+    */
+    bool IsSettled();
+
+    /**
+     * return number of gate inputs this wire drives
+     * 
+     * @return number of output connections
+    */
+    int OutputConnectionSize();
+
+    /**
+     * return gate driven by an output connection of this wire
+     * 
+     * @param aConnectionIndex output connection number
+    */
+    CLogic* GetConnectedLogic(int aConnectionIndex);
+
+    /**
+     * return which gate input is driven by an output connection of this wire
+     * 
+     * @param aConnectionIndex output connection number
+    */
+    int GetConnectedInput(int aConnectionIndex);
+
   private:
     static const int MaxFanout = 2;     // max gate inputs that one gate output can drive 
+    static const int MaxDrives = 1024;  // max times one wire is driven while draining the worklist
     int mNumOutputConnections;            // how many outputs are connected
     CLogic *mpGatesToDrive[MaxFanout];    // list of connected gates
     int mGateInputIndices[MaxFanout];     // list of input to drive in each gate
+    unsigned mDrain;                      // drain this wire was last driven in
+    int mDrives;                          // times driven in that drain
+    bool mSettled;                        // false once mDrives passed MaxDrives
 };
 
 #endif
\ No newline at end of file
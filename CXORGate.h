@@ -14,6 +14,17 @@ public:
     */
     CXORGate();
 
+    /**
+     * Append this gate to a flattened netlist
+     * 
+     * @param aNetlist netlist to append to
+     * @param aPrefix hierarchical name prefix (unused by gates)
+     * @param aInputNets net driving each input
+     * @param aOutputNets net carrying each output
+    */
+    void Flatten(CNetlist &aNetlist, const std::string &aPrefix,
+                 const std::vector<int> &aInputNets, const std::vector<int> &aOutputNets);
+
 private:
     /**
      * Compute the output levels of this Clogic object
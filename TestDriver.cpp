@@ -6,7 +6,13 @@
 #include "CORGate.h"
 #include "CXORGate.h"
 #include "CNOTGate.h"
+#include "CDFFGate.h"
 #include "CCircuit.h"
+#include "CNetlist.h"
+#include "CToggleAnalyzer.h"
+#include "CVcdWriter.h"
+#include "CNetlistReader.h"
+#include "CPerfCounters.h"
 
 #include <utility>
 #include <vector>
@@ -14,6 +20,11 @@
 #include <string>
 #include <bitset>
 #include <cmath>
+#include <random>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
 
 //--TestDriver Implementation-------------------------------------------------------------------
 std::pair<std::string, CLogic*> TestDriver::NewCircuit () {
@@ -59,6 +70,22 @@ std::pair<std::string, CLogic*> TestDriver::NewCircuit () {
             {
                 Gate = new CNOTGate();
             }
+            else if (GateType.compare( "dff" ) == 0)
+            {
+                Gate = new CDFFGate();
+            }
+            else if (GateType.compare( "dffe" ) == 0)
+            {
+                Gate = new CDFFGate(true, false);
+            }
+            else if (GateType.compare( "dffr" ) == 0)
+            {
+                Gate = new CDFFGate(false, true);
+            }
+            else if (GateType.compare( "dffre" ) == 0)
+            {
+                Gate = new CDFFGate(true, true);
+            }
             else 
             {
                 std::cout << "Unrecognised gate " << GateType << std::endl;
@@ -139,6 +166,10 @@ std::pair<std::string, CLogic*> TestDriver::NewCircuit () {
         }
     }
 
+    // Report any combinational loops
+    CNetlist Netlist(Circuit);
+    Netlist.ReportLoops();
+
     // Return circuit name and pointer
     return std::make_pair(CircuitName, Circuit);
 }
@@ -178,6 +209,18 @@ void TestDriver::TestCircuit (std::pair<std::string, CLogic*> &CircuitInfo, std:
                     << " >>> "
                     << " Output: " << Output
                     << std::endl;
+
+        // Name wires left oscillating on a combinational loop. Their outputs read LOGIC_UNDEFINED
+        // here as in CNetlist, but the undefined level then spreads round the whole loop, where 
+        // CNetlist keeps the last level of loop nets that had stopped changing.
+        CCircuit* Nested = dynamic_cast<CCircuit*>(Circuit);
+        if (Nested != NULL)
+        {
+            for (std::string Wire : Nested->UnsettledWires())
+            {
+                std::cout << "[" << Name << "] Wire " << Wire << " did not settle" << std::endl;
+            }
+        }
     }
     else 
     {
@@ -191,4 +234,474 @@ void TestDriver::TestCircuit (std::pair<std::string, CLogic*> &CircuitInfo, std:
         Input.pop_back();
     }
     return;
-}
\ No newline at end of file
+}
+
+void TestDriver::TestOutputs (std::pair<std::string, CLogic*> &CircuitInfo, std::vector<int> Outputs)
+{
+    CNetlist Netlist(CircuitInfo.second);
+    for (int Output : Outputs)
+    {
+        if (Output < 0 || Output >= Netlist.OutputSize())
+        {
+            std::cout << "Circuit has no output " << Output << std::endl;
+            return;
+        }
+    }
+    CEvalContext Context(Netlist);
+    COutputCone Cone = Netlist.MakeCone(Outputs);
+    std::cout << "[" << CircuitInfo.first << "] Cone of " << Outputs.size() << " outputs holds "
+              << Cone.GateSize() << " of " << Netlist.GateSize() << " gates" << std::endl;
+
+    // Drive each assignment, input 0 as the most significant bit
+    const int InputWidth = Netlist.InputSize();
+    const uint64_t Total = (InputWidth >= 64) ? ~uint64_t(0) : (uint64_t(1) << InputWidth);
+    std::vector<eLogicLevel> Inputs(InputWidth);
+    std::vector<eLogicLevel> Levels;
+    for (uint64_t Assignment = 0; Assignment < Total; Assignment++)
+    {
+        std::string Input = "";
+        for (int j = 0; j < InputWidth; j++)
+        {
+            bool High = (Assignment >> (InputWidth - 1 - j)) & 1;
+            Inputs[j] = High ? LOGIC_HIGH : LOGIC_LOW;
+            Input.push_back(High ? '1' : '0');
+        }
+        Netlist.EvaluateCone(Context, Cone, Inputs, Levels);
+
+        std::string Output = "";
+        for (eLogicLevel Level : Levels)
+        {
+            Output.push_back((Level == LOGIC_HIGH) ? '1' : (Level == LOGIC_LOW) ? '0' : 'Z');
+        }
+        std::cout << "[" << CircuitInfo.first << "]"
+                  << " Input: " << Input
+                  << " >>> "
+                  << " Output: " << Output
+                  << std::endl;
+    }
+}
+
+void TestDriver::CollapseCircuit (std::pair<std::string, CLogic*> &CircuitInfo, int MaxInputs, size_t Budget)
+{
+    CCircuit* Circuit = dynamic_cast<CCircuit*>(CircuitInfo.second);
+    if (Circuit == NULL) return;
+    int Collapsed = Circuit->Collapse(MaxInputs, Budget);
+    std::cout << "[" << CircuitInfo.first << "] Collapsed " << Collapsed << " circuits into truth tables"
+              << std::endl;
+}
+
+void TestDriver::ToggleCircuit (std::pair<std::string, CLogic*> &CircuitInfo, uint64_t Patterns)
+{
+    CNetlist Netlist(CircuitInfo.second);
+    CEvalContext Context(Netlist);
+    CToggleAnalyzer Analyzer(Netlist);
+    std::vector<LogicWord> Inputs;
+    std::vector<LogicWord> Outputs;
+
+    // Exhaustive sweep for narrow circuits, random assignments otherwise, 64 per evaluation
+    const bool Sweep = Netlist.InputSize() <= 24;
+    if (Sweep) Patterns = uint64_t(1) << Netlist.InputSize();
+    auto Stream = [&](uint64_t Count, uint64_t Repeats, CToggleAnalyzer *apAnalyzer) {
+        Inputs.resize(Netlist.InputSize());
+        auto Begin = std::chrono::steady_clock::now();
+        for (uint64_t r = 0; r < Repeats; r++)
+        {
+            std::mt19937_64 Random(1);
+            for (uint64_t First = 0; First < Count; First += 64)
+            {
+                int Valid = (Count - First < 64) ? int(Count - First) : 64;
+                if (Sweep) Netlist.SweepWords(First, Inputs);
+                else
+                {
+                    for (LogicWord &Word : Inputs)
+                    {
+                        Word.mHigh = Random();
+                        Word.mUndefined = 0;
+                    }
+                }
+                if (apAnalyzer != NULL) Netlist.EvaluateWords(Context, Inputs, Outputs, *apAnalyzer, Valid);
+                else Netlist.EvaluateWords(Context, Inputs, Outputs);
+            }
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - Begin).count();
+    };
+    Stream(Patterns, 1, &Analyzer);
+    std::cout << "[" << CircuitInfo.first << "] ";
+    Analyzer.Report(std::cout);
+
+    // The cost of recording, against evaluating the same words without it. Short streams are 
+    // repeated to be long enough to time.
+    CToggleAnalyzer Scratch(Netlist);
+    uint64_t Repeats = std::max<uint64_t>(1, (1 << 16) / Patterns);
+    double Plain = Stream(Patterns, Repeats, NULL);
+    double Recorded = Stream(Patterns, Repeats, &Scratch);
+    std::cout << "[" << CircuitInfo.first << "] Recording adds " << std::fixed << std::setprecision(1)
+              << 100 * (Recorded / Plain - 1) << "% to evaluating the patterns" << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+    std::cout.precision(6);
+}
+
+void TestDriver::TraceCircuit (std::pair<std::string, CLogic*> &CircuitInfo, std::string Path,
+                               std::vector<std::string> Selection)
+{
+    CNetlist Netlist(CircuitInfo.second);
+    CEvalContext Context(Netlist);
+    CVcdWriter Writer(Netlist, Path, Selection);
+    if (!Writer.IsOpen()) return;
+
+    // Drive each assignment, input 0 as the most significant bit
+    const int InputWidth = Netlist.InputSize();
+    const uint64_t Total = (InputWidth >= 64) ? ~uint64_t(0) : (uint64_t(1) << InputWidth);
+    std::vector<eLogicLevel> Inputs(InputWidth);
+    std::vector<eLogicLevel> Outputs;
+    for (uint64_t Assignment = 0; Assignment < Total; Assignment++)
+    {
+        for (int j = 0; j < InputWidth; j++)
+        {
+            Inputs[j] = ((Assignment >> (InputWidth - 1 - j)) & 1) ? LOGIC_HIGH : LOGIC_LOW;
+        }
+        Netlist.Evaluate(Context, Inputs, Outputs);
+        Writer.Sample(Assignment, Context);
+    }
+
+    std::cout << "[" << CircuitInfo.first << "] Traced " << Writer.TracedSize() << " nets to "
+              << Path << std::endl;
+}
+
+void TestDriver::CheckEdits (std::pair<std::string, CLogic*> &CircuitInfo, int Edits)
+{
+    CNetlist Netlist(CircuitInfo.second);
+    std::vector<CEvalContext> Contexts(4, CEvalContext(Netlist));
+    std::vector<eLogicLevel> Inputs(Netlist.InputSize());
+    std::mt19937 Random(1);
+    auto RandomInputs = [&]() {
+        for (eLogicLevel &Level : Inputs) Level = (Random() % 8 == 0) ? LOGIC_UNDEFINED : eLogicLevel(Random() % 2);
+    };
+
+    // Sources never get a driver
+    auto IsSource = [&](int Net) {
+        for (int i = 0; i < Netlist.InputSize(); i++)
+        {
+            if (Netlist.InputNet(i) == Net) return true;
+        }
+        for (int f = 0; f < Netlist.FlopSize(); f++)
+        {
+            if (Netlist.FlopOutput(f) == Net) return true;
+        }
+        return false;
+    };
+    auto RandomGate = [&]() {
+        std::vector<int> Gates;
+        for (int Net = 0; Net < Netlist.NetSize(); Net++)
+        {
+            if (Netlist.NetDriver(Net) >= 0) Gates.push_back(Netlist.NetDriver(Net));
+        }
+        return Gates.empty() ? -1 : Gates[Random() % Gates.size()];
+    };
+    auto RandomNet = [&]() { return int(Random() % Netlist.NetSize()); };
+
+    RandomInputs();
+    int Mismatches = CompareEngines(Netlist, Contexts, Inputs);
+    int Created = 0, Broken = 0, Resized = 0, Rejected = 0, Replaced = 0, Reordered = 0;
+    for (int e = 0; e < Edits; e++)
+    {
+        int Loops = Netlist.LoopSize();
+        int Gate = RandomGate();
+        eGateOp Op = eGateOp(Random() % 5);
+        switch ((Gate < 0) ? 0 : Random() % 7)
+        {
+        case 0:
+        {
+            // New gate on a new net, or replacing the driver of a net, reading any nets
+            int Output = (Random() % 2) ? Netlist.AddNet() : RandomNet();
+            if (IsSource(Output)) Output = Netlist.AddNet();
+            if (Netlist.AddGate(Op, RandomNet(), RandomNet(), Output) < 0) Rejected++;
+            break;
+        }
+        case 1:
+            Netlist.RemoveGate(Gate);
+            break;
+        case 2:
+        {
+            // Sometimes leaves out the second input a single input gate needs to become two input
+            int Before = Netlist.GateInputSize(Gate);
+            if (!Netlist.ReplaceGate(Gate, Op, (Random() % 4 == 0) ? -1 : RandomNet())) Rejected++;
+            else if (Netlist.GateInputSize(Gate) != Before) Resized++;
+            break;
+        }
+        case 3:
+            if (!Netlist.ReconnectInput(Gate, Random() % 2, (Random() % 8 == 0) ? -1 : RandomNet())) Rejected++;
+            break;
+        case 4:
+        {
+            int Output = RandomNet();
+            if (!IsSource(Output)) Netlist.ReconnectOutput(Gate, Output);
+            break;
+        }
+        case 5:
+            // Rarely, since renumbering every net makes the incremental context start over
+            if (Random() % 8 != 0) break;
+            Netlist.Reorder();
+            Reordered++;
+            break;
+        default:
+        {
+            // Replacing the driver of a loop net removes a loop gate, which rebuilds the order
+            // while the replacement is added, then removing the replacement drops it from its level
+            if (Loops == 0) break;
+            std::vector<int> Nets = Netlist.LoopNets(Random() % Loops);
+            int Replacement = Netlist.AddGate(Op, RandomNet(), RandomNet(), Nets[Random() % Nets.size()]);
+            if (Replacement < 0) Rejected++;
+            else
+            {
+                Netlist.RemoveGate(Replacement);
+                Replaced++;
+            }
+            break;
+        }
+        }
+        if (Netlist.LoopSize() > Loops) Created++;
+        if (Netlist.LoopSize() < Loops) Broken++;
+
+        RandomInputs();
+        Mismatches += CompareEngines(Netlist, Contexts, Inputs);
+    }
+
+    std::cout << "[" << CircuitInfo.first << "] " << Edits << " edits, " << Created << " creating loops, "
+              << Broken << " breaking loops, " << Resized << " changing input count, " << Replaced
+              << " replacing loop drivers, " << Reordered << " reordering, " << Rejected << " rejected"
+              << std::endl;
+    std::cout << "[" << CircuitInfo.first << "] Incremental evaluation "
+              << ((Mismatches == 0) ? "matches" : "DIFFERS from") << " full evaluation";
+    if (Mismatches != 0) std::cout << " on " << Mismatches << " nets";
+    std::cout << std::endl;
+}
+
+int TestDriver::CompareEngines (CNetlist &Netlist, std::vector<CEvalContext> &Contexts,
+                                const std::vector<eLogicLevel> &Inputs)
+{
+    // Every pattern of the wide engines gets the same inputs
+    std::vector<LogicWord> Words(Inputs.size());
+    std::vector<LogicBlock> Blocks(Inputs.size());
+    for (int i = 0; i < int(Inputs.size()); i++)
+    {
+        uint64_t High = (Inputs[i] == LOGIC_HIGH) ? ~uint64_t(0) : 0;
+        uint64_t Undefined = (Inputs[i] == LOGIC_UNDEFINED) ? ~uint64_t(0) : 0;
+        Words[i].mHigh = High;
+        Words[i].mUndefined = Undefined;
+        for (int w = 0; w < LogicBlock::Words; w++)
+        {
+            Blocks[i].mHigh[w] = High;
+            Blocks[i].mUndefined[w] = Undefined;
+        }
+    }
+    std::vector<eLogicLevel> Outputs;
+    std::vector<LogicWord> WordOutputs;
+    std::vector<LogicBlock> BlockOutputs;
+    Netlist.Reevaluate(Contexts[0], Inputs, Outputs);
+    Netlist.Evaluate(Contexts[1], Inputs, Outputs);
+    Netlist.EvaluateWords(Contexts[2], Words, WordOutputs);
+    Netlist.EvaluateBlocks(Contexts[3], Blocks, BlockOutputs);
+
+    int Mismatches = 0;
+    for (int Net = 0; Net < Netlist.NetSize(); Net++)
+    {
+        eLogicLevel Level = Contexts[0].GetNetLevel(Net);
+        LogicWord Expected;
+        Expected.mHigh = (Level == LOGIC_HIGH) ? ~uint64_t(0) : 0;
+        Expected.mUndefined = (Level == LOGIC_UNDEFINED) ? ~uint64_t(0) : 0;
+        const LogicWord &Word = Contexts[2].GetNetWord(Net);
+        const LogicBlock &Block = Contexts[3].GetNetBlock(Net);
+        bool Same = Contexts[1].GetNetLevel(Net) == Level && Word.mHigh == Expected.mHigh &&
+                    Word.mUndefined == Expected.mUndefined;
+        for (int w = 0; w < LogicBlock::Words; w++)
+        {
+            Same = Same && Block.mHigh[w] == Expected.mHigh && Block.mUndefined[w] == Expected.mUndefined;
+        }
+        if (!Same) Mismatches++;
+    }
+    return Mismatches;
+}
+
+void TestDriver::SimulateCycles (std::pair<std::string, CLogic*> &CircuitInfo, uint64_t Cycles,
+                                 std::string StimulusPath)
+{
+    CNetlist Netlist(CircuitInfo.second);
+    CEvalContext Context(Netlist);
+    std::ifstream Stimulus;
+    if (!StimulusPath.empty())
+    {
+        Stimulus.open(StimulusPath);
+        if (!Stimulus.is_open())
+        {
+            std::cout << "Cannot open stimulus file " << StimulusPath << std::endl;
+            return;
+        }
+    }
+
+    // Lines are gathered in a buffer written in large blocks, so printing keeps up with the clock
+    const int InputWidth = Netlist.InputSize();
+    std::vector<eLogicLevel> Inputs(InputWidth);
+    std::vector<eLogicLevel> Outputs;
+    std::mt19937_64 Random(1);
+    std::string Line;
+    std::string Buffer;
+    const char Symbols[] = {'Z', '0', '1'};         // by level, LOGIC_UNDEFINED first
+    uint64_t Cycle = 0;
+    auto Start = std::chrono::steady_clock::now();
+    for (; Cycle < Cycles; Cycle++)
+    {
+        // Inputs from the next stimulus line, missing levels undefined, else random
+        if (Stimulus.is_open())
+        {
+            if (!std::getline(Stimulus, Line)) break;
+            for (int j = 0; j < InputWidth; j++)
+            {
+                char Symbol = (j < int(Line.size())) ? Line[j] : 'Z';
+                Inputs[j] = (Symbol == '1') ? LOGIC_HIGH : (Symbol == '0') ? LOGIC_LOW : LOGIC_UNDEFINED;
+            }
+        }
+        else
+        {
+            uint64_t Bits = 0;
+            for (int j = 0; j < InputWidth; j++)
+            {
+                if (j % 64 == 0) Bits = Random();
+                Inputs[j] = ((Bits >> (j % 64)) & 1) ? LOGIC_HIGH : LOGIC_LOW;
+            }
+        }
+
+        Netlist.Cycle(Context, Inputs, Outputs);
+        Buffer += "[" + CircuitInfo.first + "] Cycle " + std::to_string(Cycle) + " Input: ";
+        for (eLogicLevel Level : Inputs) Buffer.push_back(Symbols[Level + 1]);
+        Buffer += " >>>  Output: ";
+        for (eLogicLevel Level : Outputs) Buffer.push_back(Symbols[Level + 1]);
+        Buffer.push_back('\n');
+        if (Buffer.size() >= (1 << 16))
+        {
+            std::cout.write(Buffer.data(), Buffer.size());
+            Buffer.clear();
+        }
+    }
+    std::cout.write(Buffer.data(), Buffer.size());
+    double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+    std::cout << "[" << CircuitInfo.first << "] Simulated " << Cycle << " cycles of "
+              << Netlist.GateSize() << " gates and " << Netlist.FlopSize() << " flip-flops in "
+              << Seconds << " s, " << Cycle / Seconds << " cycles/s" << std::endl;
+}
+
+void TestDriver::BenchmarkNetlist (std::string Path, uint64_t Patterns)
+{
+    CNetlist Netlist;
+    CNetlistReader Reader(Netlist);
+    auto Start = std::chrono::steady_clock::now();
+    if (!Reader.Read(Path))
+    {
+        std::cout << Reader.Error() << std::endl;
+        return;
+    }
+    double LoadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+    std::cout << "[" << Path << "] Loaded " << Netlist.GateSize() << " gates, "
+              << Netlist.InputSize() << " inputs, " << Netlist.OutputSize() << " outputs, "
+              << Netlist.LevelSize() << " levels, " << Reader.LatchSize() << " flip-flops in "
+              << LoadSeconds << " s" << std::endl;
+    Netlist.ReportLoops();
+
+    // Random assignments, 512 per evaluation, stopping early after a second on large netlists.
+    // The reordered netlist evaluates the same assignments, checked against the netlist as
+    // loaded, then with every kernel the CPU supports, each checked against the fastest. Netlists
+    // with flip-flops are clocked once per evaluation, as 512 independent runs. Net traffic 
+    // counts the two input and one output blocks each gate touches.
+    CPerfCounters Counters;
+    std::vector<LogicBlock> Inputs(Netlist.InputSize());
+    std::vector<LogicBlock> Outputs;
+    uint64_t Checksum = 0;
+    double Rate = 0;
+    auto Evaluate = [&](std::string Layout, uint64_t Limit, bool Timed, eKernel Kernel) {
+        // Allocate the context's blocks before timing, leaving every net undefined
+        CEvalContext Context(Netlist);
+        Netlist.EvaluateBlocks(Context, std::vector<LogicBlock>(), Outputs, Kernel);
+        std::mt19937_64 Random(1);
+        uint64_t Evaluated = 0;
+        Checksum = 0;
+        auto Begin = std::chrono::steady_clock::now();
+        Counters.Start();
+        while (Evaluated < Limit &&
+               (!Timed || Evaluated == 0 || std::chrono::steady_clock::now() - Begin < std::chrono::seconds(1)))
+        {
+            for (LogicBlock &Block : Inputs)
+            {
+                for (int w = 0; w < LogicBlock::Words; w++)
+                {
+                    Block.mHigh[w] = Random();
+                    Block.mUndefined[w] = 0;
+                }
+            }
+            if (Netlist.FlopSize() == 0) Netlist.EvaluateBlocks(Context, Inputs, Outputs, Kernel);
+            else Netlist.CycleBlocks(Context, Inputs, Outputs, Kernel);
+            for (const LogicBlock &Block : Outputs)
+            {
+                for (int w = 0; w < LogicBlock::Words; w++)
+                {
+                    Checksum = (Checksum * 31 + Block.mHigh[w]) * 31 + Block.mUndefined[w];
+                }
+            }
+            Evaluated += 64 * LogicBlock::Words;
+        }
+        Counters.Stop();
+        double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Begin).count();
+        double Evaluations = Evaluated * double(Netlist.GateSize());
+        Rate = Evaluated / Seconds;
+        std::cout << "[" << Path << "] " << Layout << ", " << CNetlist::KernelName(Kernel) << ": "
+                  << Evaluated << " patterns, "
+                  << Evaluated / Seconds << ((Netlist.FlopSize() == 0) ? " patterns/s, " : " cycles/s, ")
+                  << Evaluations / Seconds << " gate evaluations/s, "
+                  << Evaluations * 3 * sizeof(LogicBlock) / (64 * LogicBlock::Words) / Seconds / 1e9
+                  << " GB/s net traffic";
+        for (int c = 0; c < COUNTER_SIZE; c++)
+        {
+            eCounter Counter = eCounter(c);
+            if (!Counters.IsAvailable(Counter)) continue;
+            std::cout << ", " << Counters.GetValue(Counter) << " " << CPerfCounters::GetName(Counter);
+        }
+        std::cout << std::endl;
+        return Evaluated;
+    };
+    const eKernel Best = CNetlist::BestKernel();
+    uint64_t Evaluated = Evaluate("As loaded", Patterns, true, Best);
+    uint64_t LoadedChecksum = Checksum;
+    double LoadedRate = Rate;
+    eCounter Misses[] = {COUNTER_L1D_MISSES, COUNTER_LLC_MISSES};
+    uint64_t LoadedMisses[] = {Counters.GetValue(Misses[0]), Counters.GetValue(Misses[1])};
+
+    Start = std::chrono::steady_clock::now();
+    Netlist.Reorder();
+    double ReorderSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+    std::cout << "[" << Path << "] Reordered for locality in " << ReorderSeconds << " s" << std::endl;
+    Evaluate("Reordered", Evaluated, false, Best);
+    uint64_t BestChecksum = Checksum;
+    std::cout << "[" << Path << "] Reordered outputs "
+              << ((BestChecksum == LoadedChecksum) ? "match" : "DIFFER from") << " as loaded" << std::endl;
+
+    // Both runs evaluate the same assignments, so their miss counts compare directly
+    std::cout << "[" << Path << "] Reordering gives " << Rate / LoadedRate << "x the throughput";
+    for (int m = 0; m < 2; m++)
+    {
+        if (!Counters.IsAvailable(Misses[m]) || LoadedMisses[m] == 0) continue;
+        std::cout << ", " << double(Counters.GetValue(Misses[m])) / LoadedMisses[m] << "x the "
+                  << CPerfCounters::GetName(Misses[m]) << " (" << LoadedMisses[m] << " to "
+                  << Counters.GetValue(Misses[m]) << ")";
+    }
+    std::cout << std::endl;
+    for (int k = Best - 1; k >= KERNEL_PORTABLE; k--)
+    {
+        Evaluate("Reordered", Evaluated, false, eKernel(k));
+        std::cout << "[" << Path << "] " << CNetlist::KernelName(eKernel(k))
+                  << ((Checksum == BestChecksum) ? " outputs match " : " outputs DIFFER from ")
+                  << CNetlist::KernelName(Best) << std::endl;
+    }
+    if (!Counters.IsAvailable(COUNTER_L1D_MISSES) && !Counters.IsAvailable(COUNTER_LLC_MISSES))
+    {
+        std::cout << "[" << Path << "] Cache miss counters unavailable" << std::endl;
+    }
+}
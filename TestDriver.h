@@ -3,8 +3,12 @@
 
 //--Includes-------------------------------------------------------------------
 #include "CLogic.h"
+#include "CNetlist.h"
 
 #include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
 
 //---TestDriver Declaration--------------------------------------------------
 //
@@ -27,8 +31,12 @@
 //    _____________________________________________|_______________________________________________
 //
 //      component {gateType} {gateName}               > "component" declares new component of type 
-//                                                       {gateType}[and, or, xor, not] and name 
-//                                                       {gateName}
+//                                                       {gateType}[and, or, xor, not, dff, dffe, 
+//                                                       dffr, dffre] and name {gateName}. dff is a
+//                                                       D flip-flop with input 0 D; dffe adds
+//                                                       enable as input 1, dffr adds synchronous
+//                                                       reset as input 1, dffre has both, enable
+//                                                       first. Flip-flops power up LOW.
 //
 //      wire {wireName} {inputNo} {gateName}          > "wire" declares new wire {wireName} if it 
 //                                                        doesnt exist and connects it to input 
@@ -53,7 +61,7 @@ class TestDriver
 {
   public:
     /**
-     * Creates a new circuit from a .circuit file piped to cin.
+     * Creates a new circuit from a .circuit file piped to cin, reporting any combinational loops.
      * 
      * @return pair containing circuit name and circuit object pointer
     */
@@ -69,7 +77,97 @@ class TestDriver
     */
     void TestCircuit (std::pair<std::string, CLogic*> &CircuitInfo, std::string &Input, int i = 0);
 
+    /**
+     * Prints truth table of some outputs of a circuit, evaluating only the gates they depend on.
+     * 
+     * @param CircuitInfo pair containing circuit name and circuit object pointer
+     * @param Outputs output numbers to print
+    */
+    void TestOutputs (std::pair<std::string, CLogic*> &CircuitInfo, std::vector<int> Outputs);
+
+    /**
+     * Collapses a circuit, or the circuits nested inside it, into truth tables, printing how 
+     * many were collapsed.
+     * 
+     * @param CircuitInfo pair containing circuit name and circuit object pointer
+     * @param MaxInputs most inputs of a collapsed circuit
+     * @param Budget most bytes of table memory to build
+    */
+    void CollapseCircuit (std::pair<std::string, CLogic*> &CircuitInfo, int MaxInputs = 12,
+                          size_t Budget = 1 << 20);
+
+    /**
+     * Prints switching activity of every net of a circuit. Sweeps all assignments 64 at a time,
+     * or a stream of random assignments for circuits too wide to sweep, then times what recording
+     * adds to evaluating the same assignments.
+     * 
+     * @param CircuitInfo pair containing circuit name and circuit object pointer
+     * @param Patterns number of random assignments to use when the circuit is too wide to sweep
+    */
+    void ToggleCircuit (std::pair<std::string, CLogic*> &CircuitInfo, uint64_t Patterns = 1 << 20);
+
+    /**
+     * Writes a VCD waveform of a circuit driven with every assignment in truth table order, one
+     * assignment per time step.
+     * 
+     * @param CircuitInfo pair containing circuit name and circuit object pointer
+     * @param Path VCD file to write
+     * @param Selection glob patterns of wire and gate output names to trace, empty to trace all
+    */
+    void TraceCircuit (std::pair<std::string, CLogic*> &CircuitInfo, std::string Path,
+                       std::vector<std::string> Selection);
+
+    /**
+     * Checks incremental evaluation of a flattened circuit against full evaluation. Applies a 
+     * stream of random netlist edits (adding, removing, replacing and reconnecting gates, which 
+     * creates and breaks combinational loops and changes gates' input counts, replacing the
+     * drivers of loop nets then removing the replacements, and now and then reordering the
+     * netlist), and after each one drives random inputs and compares every net after Reevaluate
+     * with Evaluate, EvaluateWords and EvaluateBlocks in contexts with the same history.
+     * 
+     * @param CircuitInfo pair containing circuit name and circuit object pointer
+     * @param Edits number of edits to apply
+    */
+    void CheckEdits (std::pair<std::string, CLogic*> &CircuitInfo, int Edits = 1000);
+
+    /**
+     * Clocks a circuit once per cycle, printing its inputs and outputs after every clock edge. 
+     * The combinational logic is flattened and evaluated in level order once per cycle, then 
+     * every flip-flop loads its next state.
+     * 
+     * @param CircuitInfo pair containing circuit name and circuit object pointer
+     * @param Cycles most cycles to simulate
+     * @param StimulusPath file with one line of input levels (0, 1 or Z) per cycle, empty to
+     *                     drive random levels
+    */
+    void SimulateCycles (std::pair<std::string, CLogic*> &CircuitInfo, uint64_t Cycles,
+                         std::string StimulusPath = "");
+
+    /**
+     * Loads a benchmark netlist file (.aig, .aag, .blif or .bench), then prints its size, how
+     * long it took to load and how fast it evaluates random assignments 512 at a time, as loaded
+     * and reordered for locality, with hardware cache miss counts where available, and how much
+     * reordering changes the throughput and misses. The reordered netlist is evaluated with
+     * every vector kernel the CPU supports, checking they agree. Netlists with flip-flops are
+     * clocked once per evaluation.
+     * 
+     * @param Path netlist file to read
+     * @param Patterns number of random assignments to evaluate, fewer if they take over a second
+    */
+    void BenchmarkNetlist (std::string Path, uint64_t Patterns = 1 << 20);
+
   private:
+    /**
+     * Private function evaluating a netlist with every engine, for CheckEdits.
+     * 
+     * @param Netlist netlist to evaluate
+     * @param Contexts contexts for Reevaluate, Evaluate, EvaluateWords and EvaluateBlocks
+     * @param Inputs level of each input
+     * @return number of nets where an engine disagrees with Reevaluate
+    */
+    int CompareEngines (CNetlist &Netlist, std::vector<CEvalContext> &Contexts,
+                        const std::vector<eLogicLevel> &Inputs);
+
     /**
      * Private function for testing a particular assignment on a circuit.
      * 
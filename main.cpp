@@ -2,26 +2,122 @@
 //
 // Calls TestDriver class to test combinatorial logic circuits.
 //
+// Options:
+//      -collapse               evaluate the circuit, or the circuits nested inside it, by truth
+//                              table lookup
+//      -output {n}             also print the truth table of output {n} alone, evaluating only
+//                              the gates it depends on, may be repeated
+//      -toggle                 also print the switching activity of every net
+//      -vcd {file}             also write a VCD waveform of the truth table to {file}
+//      -trace {pattern}        trace only nets whose name matches glob {pattern} in the VCD,
+//                              may be repeated
+//      -check                  also check incremental evaluation against full evaluation over
+//                              a stream of random edits to the flattened circuit
+//      -cycles {n}             also clock the circuit for {n} cycles with random inputs,
+//                              printing the outputs after each clock edge
+//      -stimulus {file}        clock the circuit with one line of inputs from {file} per cycle,
+//                              until the file ends or {n} cycles are done
+//      -read {file}            instead of reading a circuit from cin, load the benchmark netlist
+//                              {file} (.aig, .aag, .blif or .bench) and time its evaluation
+//
 // Copyright (c) Daniel Shen 2023
 
 //--Includes-------------------------------------------------------------------
 #include "TestDriver.h"
 
 #include <string>
+#include <vector>
 #include <iostream>
+#include <cstdlib>
+#include <cstdint>
 
 //---Main----------------------------------------------------------------------
-int main()
+int main(int argc, char *argv[])
 {
     // Create new testdriver
     TestDriver T = TestDriver();
 
+    // Benchmark netlist file instead of a piped circuit
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (std::string(argv[i]).compare( "-read" ) == 0)
+        {
+            T.BenchmarkNetlist(argv[i + 1]);
+            return 0;
+        }
+    }
+
     // Create new circuit
     auto CircuitInfo = T.NewCircuit();
 
+    // Collapse before testing, so the truth table is read from the tables
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::string(argv[i]).compare( "-collapse" ) == 0) T.CollapseCircuit(CircuitInfo);
+    }
+
     // Test circuit with all assignments
     std::string Assignment = "";
     T.TestCircuit(CircuitInfo, Assignment);
+
+    // Optional analyses
+    std::string VcdPath = "";
+    std::vector<std::string> Traced;
+    std::vector<int> Selected;
+    uint64_t Cycles = 0;
+    std::string StimulusPath = "";
+    for (int i = 1; i < argc; i++)
+    {
+        std::string Option = argv[i];
+        if (Option.compare( "-toggle" ) == 0)
+        {
+            T.ToggleCircuit(CircuitInfo);
+        }
+        else if (Option.compare( "-collapse" ) == 0)
+        {
+            // Done before testing
+        }
+        else if (Option.compare( "-vcd" ) == 0 && i + 1 < argc)
+        {
+            VcdPath = argv[++i];
+        }
+        else if (Option.compare( "-trace" ) == 0 && i + 1 < argc)
+        {
+            Traced.push_back(argv[++i]);
+        }
+        else if (Option.compare( "-output" ) == 0 && i + 1 < argc)
+        {
+            Selected.push_back(atoi(argv[++i]));
+        }
+        else if (Option.compare( "-check" ) == 0)
+        {
+            T.CheckEdits(CircuitInfo);
+        }
+        else if (Option.compare( "-cycles" ) == 0 && i + 1 < argc)
+        {
+            Cycles = strtoull(argv[++i], NULL, 10);
+        }
+        else if (Option.compare( "-stimulus" ) == 0 && i + 1 < argc)
+        {
+            StimulusPath = argv[++i];
+        }
+        else
+        {
+            std::cout << "Unrecognised option " << Option << std::endl;
+        }
+    }
+    if (!Selected.empty())
+    {
+        T.TestOutputs(CircuitInfo, Selected);
+    }
+    if (!VcdPath.empty())
+    {
+        T.TraceCircuit(CircuitInfo, VcdPath, Traced);
+    }
+    if (Cycles > 0 || !StimulusPath.empty())
+    {
+        T.SimulateCycles(CircuitInfo, (Cycles > 0) ? Cycles : ~uint64_t(0), StimulusPath);
+    }
     
     // Delete circuit
     delete(CircuitInfo.second);